@@ -11,13 +11,58 @@
 
 /* USER CODE BEGIN Includes */
 #include "../../Drivers/LCD/lcd_driver.h"
+#include "../../Drivers/LCD/lcd_queue.h"
 #include "../../Utils/math3d.h"
 #include "../../SolarSystem/celestial_body.h"
 #include "../../SolarSystem/camera.h"
 #include "../../SolarSystem/solar_system.h"
+#include "../../SolarSystem/particle_belt.h"
 #include "../../Graphics/renderer.h"
+#include "../../Graphics/compositor.h"
+#include "../../Graphics/indexed_fb.h"
+#include "../../Graphics/dirty_rect.h"
+#include "../../Graphics/effects.h"
+#include "../../SolarSystem/planet_shader.h"
 #include <stdio.h>
 #include <string.h>
+
+// Cada cuánto avanza una columna el campo de estrellas (scroll por hardware)
+#define STAR_SCROLL_MS  200
+#define STAR_SCROLL_MAX_STEPS  4
+
+#define BOOT_FADE_MS    400
+#define PRESS_FLASH_MS  80
+
+// Barra de UI: muestra del shader activo y círculo del botón sobre fondo negro
+#define UI_BAR_HEIGHT   30
+#define UI_SWATCH_X     5
+#define UI_SWATCH_Y     5
+#define UI_SWATCH_W     150
+#define UI_SWATCH_H     20
+#define UI_BUTTON_X     170
+#define UI_BUTTON_Y     15
+#define UI_BUTTON_R     10
+
+// Columnas de la barra con algo más que fondo
+#define UI_ITEMS_WIDTH  (UI_BUTTON_X + UI_BUTTON_R + 1)
+
+// En cada paso de scroll las columnas que dan la vuelta por la izquierda tienen que ser fondo
+#if STAR_SCROLL_MAX_STEPS >= UI_SWATCH_X
+#error "STAR_SCROLL_MAX_STEPS debe ser menor que UI_SWATCH_X"
+#endif
+
+// Anillo alrededor del planeta (radio 60): desde la cámara cabe en pantalla
+#define BELT_INNER      80.0f
+#define BELT_OUTER      130.0f
+
+// Tiempo por frame para avanzar y proyectar el cinturón; el dibujo va con las activas
+#define BELT_FRAME_US   3000
+
+// Luna entre el planeta y el cinturón; la inclinación la pasa por delante y por detrás
+#define MOON_RADIUS     4.0f
+#define MOON_ORBIT      70.0f
+#define MOON_SPEED      0.8f
+#define MOON_TILT       0.35f
 /* USER CODE END Includes */
 
 SPI_HandleTypeDef hspi1;
@@ -25,6 +70,7 @@ SPI_HandleTypeDef hspi1;
 /* USER CODE BEGIN PV */
 Camera camera;
 SolarSystem solarSystem;
+ParticleBelt belt;
 uint32_t lastTick = 0;
 float deltaTime = 0.0f;
 uint32_t frameCount = 0;
@@ -35,6 +81,14 @@ ShaderType currentShader = SHADER_MERCURY;
 uint8_t needsRedraw = 1;
 uint32_t lastButtonTime = 0;
 uint8_t lastButtonState = 0;
+uint8_t buttonShown = 0;
+uint8_t uiShownState = 0xFF;
+CompositorStats frameStats;
+LCDBusStats busStats;
+uint16_t starScroll = 0;
+uint32_t lastScrollTick = 0;
+uint32_t bootTimeMs = 0;
+uint32_t beltCycles = 0;
 
 const char* shaderNames[SHADER_COUNT] = {
     "MERCURY",
@@ -54,37 +108,82 @@ void Game_Init(void);
 void Game_Update(void);
 void Game_Render(void);
 void Game_ProcessInput(void);
-void DrawShaderInfo(void);
+void DrawShaderInfo(void* ctx, CompositorTile* tile);
+void Game_ScrollStars(void);
+#if INDEXED_FB_ENABLE
+void BuildFramePalette(void);
+#endif
 /* USER CODE END PFP */
 
 /* USER CODE BEGIN 0 */
 
 void Game_Init(void)
 {
+    // La pantalla sigue apagada hasta que el primer frame esté completo
     LCD_Init();
-    LCD_Clear(COLOR_SPACE);
-
-    LCD_FillRect(60, 100, 200, 40, COLOR_BLUE);
-    HAL_Delay(500);
+    LCDQueue_Init();
+    Effects_Init(0);
 
     float aspect = (float)LCD_WIDTH / (float)LCD_HEIGHT;
     Camera_Init(&camera, 60.0f, aspect);
 
-    camera.distance = 200.0f;
-    camera.height = 100.0f;
-    camera.angle = 0.0f;
+    Camera_SetOrbit(&camera, 0.0f, 200.0f, 100.0f);
 
     SolarSystem_Init(&solarSystem);
     solarSystem.time_scale = 0.5f;
 
+    CelestialBody moon;
+    CelestialBody_Init(&moon, "Moon", BODY_TYPE_MOON);
+    CelestialBody_SetVisuals(&moon, MOON_RADIUS, COLOR_GRAY);
+    CelestialBody_SetOrbitalParams(&moon, MOON_ORBIT, MOON_SPEED, MOON_TILT);
+    BodyHandle moonHandle = SolarSystem_AddBody(&solarSystem, &moon, 0);
+
+#if SOLAR_TRAILS_ENABLE
+    SolarSystem_SetTrail(&solarSystem, moonHandle, 1);
+#else
+    (void)moonHandle;
+#endif
+
     Renderer_Init();
+    Renderer_SetupStars(12345, 80);
+
+    Belt_Init(&belt, BELT_MAX_PARTICLES, BELT_INNER, BELT_OUTER, 2.0f, 0.25f, 777);
+
+    // Contador de ciclos del núcleo para medir el cinturón
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Capas de atrás hacia adelante: fondo, órbitas, anillo lejano, estelas, cuerpos,
+    // anillo cercano, barra de UI
+    Compositor_Init(COLOR_SPACE);
+    Compositor_AddLayer(Renderer_StarsLayer, NULL);
+#if SOLAR_ORBITS_ENABLE
+    Compositor_AddLayer(SolarSystem_OrbitsLayer, &solarSystem);
+#endif
+    Compositor_AddLayer(Belt_BackLayer, &belt);
+#if SOLAR_TRAILS_ENABLE
+    Compositor_AddLayer(SolarSystem_TrailsLayer, &solarSystem);
+#endif
+    Compositor_AddLayer(SolarSystem_BodiesLayer, &solarSystem);
+    Compositor_AddLayer(Belt_FrontLayer, &belt);
+    Compositor_AddLayer(DrawShaderInfo, NULL);
+
+#if INDEXED_FB_ENABLE
+    // El compositor ya escribe en él: sin bandas dobles, hashes ni cinturón completo
+    IndexedFB_Init();
+#endif
+
+    // Toda la pantalla se desplaza; la barra de UI se recompone en cada paso
+    LCD_SetScrollArea(0, 0);
+    starScroll = 0;
 
     lastTick = HAL_GetTick();
     fpsTimer = lastTick;
     lastButtonTime = lastTick;
+    lastScrollTick = lastTick;
 
-    LCD_Clear(COLOR_SPACE);
-    Renderer_DrawStars(12345, 80);
+    needsRedraw = 1;
 }
 
 void Game_Update(void)
@@ -101,6 +200,10 @@ void Game_Update(void)
     Camera_Update(&camera, deltaTime);
     SolarSystem_Update(&solarSystem, deltaTime);
 
+    uint32_t beltStart = DWT->CYCCNT;
+    Belt_Update(&belt, deltaTime * solarSystem.time_scale);
+    beltCycles = DWT->CYCCNT - beltStart;
+
     frameCount++;
     if (currentTick - fpsTimer >= 1000) {
         fps = frameCount;
@@ -111,15 +214,87 @@ void Game_Update(void)
 
 void Game_Render(void)
 {
+    buttonShown = (HAL_GPIO_ReadPin(GPIOC, GPIO_PIN_13) == GPIO_PIN_RESET);
+
+    // Barrera con el frame anterior. Con SPI sus ráfagas por DMA se solapan con la
+    // actualización de la escena; en paralelo no hay cola y no espera nada.
+    LCDQueue_Flush();
+    Effects_Update(HAL_GetTick());
+
+    Compositor_BeginFrame();
+    LCD_ResetBusStats();
+
+    SolarSystem_PrepareFrame(&solarSystem, &camera, solarSystem.total_time);
+
+    uint32_t beltStart = DWT->CYCCNT;
+    Belt_Project(&belt, &camera, SolarSystem_GetPosition(&solarSystem, 0));
+    beltCycles += DWT->CYCCNT - beltStart;
+    Belt_FitBudget(&belt, beltCycles, BELT_FRAME_US * (SystemCoreClock / 1000000));
+
+#if INDEXED_FB_ENABLE
+    BuildFramePalette();
+#endif
+
+    // Cada productor marca lo que dañó; solo se recompone el conjunto unido
     if (needsRedraw) {
-        LCD_Clear(COLOR_SPACE);
-        Renderer_DrawStars(12345, 80);
+        Dirty_AddAll();
         needsRedraw = 0;
     }
 
-    SolarSystem_RenderWithShaders(&solarSystem, &camera, solarSystem.total_time);
+#if !INDEXED_FB_ENABLE
+    Game_ScrollStars();
+#endif
 
-    DrawShaderInfo();
+    SolarSystem_MarkDirty(&solarSystem);
+    Belt_MarkDirty(&belt);
+
+    uint8_t uiState = (uint8_t)((currentShader << 1) | buttonShown);
+    if (uiState != uiShownState) {
+        Dirty_Add(0, 0, LCD_WIDTH, UI_BAR_HEIGHT);
+        uiShownState = uiState;
+    }
+
+    Dirty_Compose();
+
+#if INDEXED_FB_ENABLE
+    // El frame completo queda en RAM antes de enviarse: sin tearing
+    LCDQueue_Flush();
+    IndexedFB_Flush();
+#endif
+
+    frameStats = *Compositor_GetStats();
+    busStats = *LCD_GetBusStats();
+
+    // Primer frame completo en la RAM del panel: se enciende y se mide el arranque
+    if (bootTimeMs == 0) {
+        LCDQueue_Flush();
+        LCD_DisplayOn();
+        Effects_FadeIn(BOOT_FADE_MS);
+        bootTimeMs = HAL_GetTick();
+    }
+}
+
+void Game_ScrollStars(void)
+{
+    uint32_t currentTick = HAL_GetTick();
+    uint16_t steps = (currentTick - lastScrollTick) / STAR_SCROLL_MS;
+
+    if (steps == 0) return;
+    if (steps > STAR_SCROLL_MAX_STEPS) steps = STAR_SCROLL_MAX_STEPS;
+    lastScrollTick = currentTick;
+
+    // Un comando mueve todo el fondo; las estrellas ya están en la RAM del panel
+    starScroll = (starScroll + steps) % LCD_WIDTH;
+    LCD_SetScroll(starScroll);
+    Renderer_SetStarDrift(starScroll);
+
+    // Lo enviado se ve desplazado: los hashes por columna ya no valen
+    Compositor_Invalidate(0, 0, LCD_WIDTH, LCD_HEIGHT);
+
+    // Lo que no es fondo vuelve a su sitio: cuerpos, cinturón y elementos de la barra
+    SolarSystem_ScrollScreen(&solarSystem, steps);
+    Belt_ScrollScreen(&belt, steps);
+    Dirty_Add(0, 0, UI_ITEMS_WIDTH, UI_BAR_HEIGHT);
 }
 
 void Game_ProcessInput(void)
@@ -129,19 +304,18 @@ void Game_ProcessInput(void)
     uint32_t currentTick = HAL_GetTick();
 
     if (buttonPressed && !lastButtonState && (currentTick - lastButtonTime > 300)) {
-        LCD_FillCircle(160, 120, 30, COLOR_WHITE);
-        HAL_Delay(50);
+        // Respuesta inmediata con la inversión del panel, sin bloquear ni repintar
+        Effects_Flash(PRESS_FLASH_MS);
 
         currentShader = (currentShader + 1) % SHADER_COUNT;
         SolarSystem_SetPlanetShader(&solarSystem, currentShader);
-        needsRedraw = 1;
         lastButtonTime = currentTick;
     }
 
     lastButtonState = buttonPressed;
 }
 
-void DrawShaderInfo(void)
+void DrawShaderInfo(void* ctx, CompositorTile* tile)
 {
     uint16_t shader_colors[6] = {
         0x8410,
@@ -152,17 +326,51 @@ void DrawShaderInfo(void)
         0x001F
     };
 
-    LCD_FillRect(0, 0, 320, 30, 0x0000);
-    LCD_FillRect(5, 5, 150, 20, shader_colors[currentShader]);
+    if (tile->y >= UI_BAR_HEIGHT) return;
+
+    Compositor_FillRect(tile, 0, 0, LCD_WIDTH, UI_BAR_HEIGHT, 0x0000);
+    Compositor_FillRect(tile, UI_SWATCH_X, UI_SWATCH_Y, UI_SWATCH_W, UI_SWATCH_H, shader_colors[currentShader]);
 
-    uint8_t buttonState = (HAL_GPIO_ReadPin(GPIOC, GPIO_PIN_13) == GPIO_PIN_RESET);
-    if (buttonState) {
-        LCD_FillCircle(170, 15, 10, COLOR_GREEN);
+    if (buttonShown) {
+        Compositor_FillCircle(tile, UI_BUTTON_X, UI_BUTTON_Y, UI_BUTTON_R, COLOR_GREEN);
     } else {
-        LCD_FillCircle(170, 15, 10, 0x2104);
+        Compositor_FillCircle(tile, UI_BUTTON_X, UI_BUTTON_Y, UI_BUTTON_R, 0x2104);
     }
 }
 
+#if INDEXED_FB_ENABLE
+void BuildFramePalette(void)
+{
+    static uint16_t palette[INDEXED_FB_COLORS];
+    uint16_t count = 0;
+
+    // Colores fijos: espacio y UI
+    palette[count++] = COLOR_SPACE;
+    palette[count++] = COLOR_GREEN;
+    palette[count++] = 0x2104;
+    palette[count++] = COLOR_WHITE;
+    palette[count++] = 0x8410;
+    palette[count++] = 0xFFE0;
+    palette[count++] = 0x047F;
+    palette[count++] = 0xFD40;
+    palette[count++] = 0xFE80;
+    palette[count++] = 0x001F;
+
+    // Rampa de grises para las estrellas (brillo 128-255)
+    for (uint16_t b = 128; b < 256; b += 8) {
+        palette[count++] = ((b >> 3) << 11) | ((b >> 2) << 5) | (b >> 3);
+    }
+
+    for (uint8_t i = 0; i < BELT_SHADES; i++) {
+        palette[count++] = belt.shades[i];
+    }
+
+    count += Shader_BuildPalette(currentShader, &palette[count], INDEXED_FB_COLORS - count);
+
+    IndexedFB_SetPalette(palette, count);
+}
+#endif
+
 /* USER CODE END 0 */
 
 int main(void)
@@ -5,23 +5,32 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../Drivers/LCD/lcd_driver.c 
+../Drivers/LCD/lcd_device_parallel.c \
+../Drivers/LCD/lcd_device_spi.c \
+../Drivers/LCD/lcd_driver.c \
+../Drivers/LCD/lcd_queue.c 
 
 C_DEPS += \
-./Drivers/LCD/lcd_driver.d 
+./Drivers/LCD/lcd_device_parallel.d \
+./Drivers/LCD/lcd_device_spi.d \
+./Drivers/LCD/lcd_driver.d \
+./Drivers/LCD/lcd_queue.d 
 
 OBJS += \
-./Drivers/LCD/lcd_driver.o 
+./Drivers/LCD/lcd_device_parallel.o \
+./Drivers/LCD/lcd_device_spi.o \
+./Drivers/LCD/lcd_driver.o \
+./Drivers/LCD/lcd_queue.o 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 Drivers/LCD/%.o Drivers/LCD/%.su Drivers/LCD/%.cyclo: ../Drivers/LCD/%.c Drivers/LCD/subdir.mk
 	arm-none-eabi-gcc "$<" -mcpu=cortex-m4 -std=gnu11 -g3 -DDEBUG -DUSE_HAL_DRIVER -DSTM32F446xx -c -I../Core/Inc -I../Drivers/STM32F4xx_HAL_Driver/Inc -I../Drivers/STM32F4xx_HAL_Driver/Inc/Legacy -I../Drivers/CMSIS/Device/ST/STM32F4xx/Include -I../Drivers/CMSIS/Include -O0 -ffunction-sections -fdata-sections -Wall -fstack-usage -fcyclomatic-complexity -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" --specs=nano.specs -mfpu=fpv4-sp-d16 -mfloat-abi=hard -mthumb -o "$@"
 
-clean: clean-Drivers-2f-LCD
+clean: clean-Drivers-LCD
 
-clean-Drivers-2f-LCD:
-	-$(RM) ./Drivers/LCD/lcd_driver.cyclo ./Drivers/LCD/lcd_driver.d ./Drivers/LCD/lcd_driver.o ./Drivers/LCD/lcd_driver.su
+clean-Drivers-LCD:
+	-$(RM) ./Drivers/LCD/lcd_device_parallel.cyclo ./Drivers/LCD/lcd_device_parallel.d ./Drivers/LCD/lcd_device_parallel.o ./Drivers/LCD/lcd_device_parallel.su ./Drivers/LCD/lcd_device_spi.cyclo ./Drivers/LCD/lcd_device_spi.d ./Drivers/LCD/lcd_device_spi.o ./Drivers/LCD/lcd_device_spi.su ./Drivers/LCD/lcd_driver.cyclo ./Drivers/LCD/lcd_driver.d ./Drivers/LCD/lcd_driver.o ./Drivers/LCD/lcd_driver.su ./Drivers/LCD/lcd_queue.cyclo ./Drivers/LCD/lcd_queue.d ./Drivers/LCD/lcd_queue.o ./Drivers/LCD/lcd_queue.su
 
-.PHONY: clean-Drivers-2f-LCD
+.PHONY: clean-Drivers-LCD
 
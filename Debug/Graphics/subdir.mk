@@ -5,12 +5,27 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Graphics/blend.c \
+../Graphics/compositor.c \
+../Graphics/dirty_rect.c \
+../Graphics/effects.c \
+../Graphics/indexed_fb.c \
 ../Graphics/renderer.c 
 
 C_DEPS += \
+./Graphics/blend.d \
+./Graphics/compositor.d \
+./Graphics/dirty_rect.d \
+./Graphics/effects.d \
+./Graphics/indexed_fb.d \
 ./Graphics/renderer.d 
 
 OBJS += \
+./Graphics/blend.o \
+./Graphics/compositor.o \
+./Graphics/dirty_rect.o \
+./Graphics/effects.o \
+./Graphics/indexed_fb.o \
 ./Graphics/renderer.o 
 
 
@@ -21,7 +36,7 @@ Graphics/%.o Graphics/%.su Graphics/%.cyclo: ../Graphics/%.c Graphics/subdir.mk
 clean: clean-Graphics
 
 clean-Graphics:
-	-$(RM) ./Graphics/renderer.cyclo ./Graphics/renderer.d ./Graphics/renderer.o ./Graphics/renderer.su
+	-$(RM) ./Graphics/blend.cyclo ./Graphics/blend.d ./Graphics/blend.o ./Graphics/blend.su ./Graphics/compositor.cyclo ./Graphics/compositor.d ./Graphics/compositor.o ./Graphics/compositor.su ./Graphics/dirty_rect.cyclo ./Graphics/dirty_rect.d ./Graphics/dirty_rect.o ./Graphics/dirty_rect.su ./Graphics/effects.cyclo ./Graphics/effects.d ./Graphics/effects.o ./Graphics/effects.su ./Graphics/indexed_fb.cyclo ./Graphics/indexed_fb.d ./Graphics/indexed_fb.o ./Graphics/indexed_fb.su ./Graphics/renderer.cyclo ./Graphics/renderer.d ./Graphics/renderer.o ./Graphics/renderer.su
 
 .PHONY: clean-Graphics
 
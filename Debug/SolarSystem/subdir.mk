@@ -7,20 +7,29 @@
 C_SRCS += \
 ../SolarSystem/camera.c \
 ../SolarSystem/celestial_body.c \
+../SolarSystem/nbody.c \
+../SolarSystem/particle_belt.c \
 ../SolarSystem/planet_shader.c \
-../SolarSystem/solar_system.c 
+../SolarSystem/solar_system.c \
+../SolarSystem/sprite_cache.c 
 
 C_DEPS += \
 ./SolarSystem/camera.d \
 ./SolarSystem/celestial_body.d \
+./SolarSystem/nbody.d \
+./SolarSystem/particle_belt.d \
 ./SolarSystem/planet_shader.d \
-./SolarSystem/solar_system.d 
+./SolarSystem/solar_system.d \
+./SolarSystem/sprite_cache.d 
 
 OBJS += \
 ./SolarSystem/camera.o \
 ./SolarSystem/celestial_body.o \
+./SolarSystem/nbody.o \
+./SolarSystem/particle_belt.o \
 ./SolarSystem/planet_shader.o \
-./SolarSystem/solar_system.o 
+./SolarSystem/solar_system.o \
+./SolarSystem/sprite_cache.o 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -30,7 +39,7 @@ SolarSystem/%.o SolarSystem/%.su SolarSystem/%.cyclo: ../SolarSystem/%.c SolarSy
 clean: clean-SolarSystem
 
 clean-SolarSystem:
-	-$(RM) ./SolarSystem/camera.cyclo ./SolarSystem/camera.d ./SolarSystem/camera.o ./SolarSystem/camera.su ./SolarSystem/celestial_body.cyclo ./SolarSystem/celestial_body.d ./SolarSystem/celestial_body.o ./SolarSystem/celestial_body.su ./SolarSystem/planet_shader.cyclo ./SolarSystem/planet_shader.d ./SolarSystem/planet_shader.o ./SolarSystem/planet_shader.su ./SolarSystem/solar_system.cyclo ./SolarSystem/solar_system.d ./SolarSystem/solar_system.o ./SolarSystem/solar_system.su
+	-$(RM) ./SolarSystem/camera.cyclo ./SolarSystem/camera.d ./SolarSystem/camera.o ./SolarSystem/camera.su ./SolarSystem/celestial_body.cyclo ./SolarSystem/celestial_body.d ./SolarSystem/celestial_body.o ./SolarSystem/celestial_body.su ./SolarSystem/nbody.cyclo ./SolarSystem/nbody.d ./SolarSystem/nbody.o ./SolarSystem/nbody.su ./SolarSystem/particle_belt.cyclo ./SolarSystem/particle_belt.d ./SolarSystem/particle_belt.o ./SolarSystem/particle_belt.su ./SolarSystem/planet_shader.cyclo ./SolarSystem/planet_shader.d ./SolarSystem/planet_shader.o ./SolarSystem/planet_shader.su ./SolarSystem/solar_system.cyclo ./SolarSystem/solar_system.d ./SolarSystem/solar_system.o ./SolarSystem/solar_system.su ./SolarSystem/sprite_cache.cyclo ./SolarSystem/sprite_cache.d ./SolarSystem/sprite_cache.o ./SolarSystem/sprite_cache.su
 
 .PHONY: clean-SolarSystem
 
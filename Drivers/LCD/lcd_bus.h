@@ -0,0 +1,27 @@
+#ifndef LCD_BUS_H
+#define LCD_BUS_H
+
+#include "main.h"
+#include "lcd_device.h"
+
+// Lado del hardware de los dispositivos de bus: pines y DMA. El resto del driver y
+// los dispositivos del host no dependen de la HAL.
+
+// Macros para control de pines
+#define LCD_CS_LOW()    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_RESET)
+#define LCD_CS_HIGH()   HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_SET)
+#define LCD_RS_LOW()    HAL_GPIO_WritePin(LCD_RS_GPIO_Port, LCD_RS_Pin, GPIO_PIN_RESET)
+#define LCD_RS_HIGH()   HAL_GPIO_WritePin(LCD_RS_GPIO_Port, LCD_RS_Pin, GPIO_PIN_SET)
+#define LCD_WR_LOW()    HAL_GPIO_WritePin(LCD_WR_GPIO_Port, LCD_WR_Pin, GPIO_PIN_RESET)
+#define LCD_WR_HIGH()   HAL_GPIO_WritePin(LCD_WR_GPIO_Port, LCD_WR_Pin, GPIO_PIN_SET)
+#define LCD_RD_LOW()    HAL_GPIO_WritePin(LCD_RD_GPIO_Port, LCD_RD_Pin, GPIO_PIN_RESET)
+#define LCD_RD_HIGH()   HAL_GPIO_WritePin(LCD_RD_GPIO_Port, LCD_RD_Pin, GPIO_PIN_SET)
+#define LCD_RST_LOW()   HAL_GPIO_WritePin(LCD_RST_GPIO_Port, LCD_RST_Pin, GPIO_PIN_RESET)
+#define LCD_RST_HIGH()  HAL_GPIO_WritePin(LCD_RST_GPIO_Port, LCD_RST_Pin, GPIO_PIN_SET)
+
+#if LCD_BACKEND == LCD_BACKEND_SPI
+// Canal TX de SPI1: DMA2 Stream3, canal 3 (configurado en HAL_SPI_MspInit)
+extern DMA_HandleTypeDef hdma_spi1_tx;
+#endif
+
+#endif
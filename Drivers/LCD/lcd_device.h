@@ -0,0 +1,99 @@
+#ifndef LCD_DEVICE_H
+#define LCD_DEVICE_H
+
+#include <stdint.h>
+
+#define LCD_BACKEND_PARALLEL  0
+#define LCD_BACKEND_SPI       1
+
+// Conexión del panel, elegida al compilar: bus 8080 de 8 bits por GPIO o SPI1 con DMA.
+// En SPI las líneas RS, CS y RST del paralelo hacen de D/C, CS y RST.
+#ifndef LCD_BACKEND
+#define LCD_BACKEND LCD_BACKEND_PARALLEL
+#endif
+
+// Entradas que guarda el registro de tráfico (16 bytes cada una)
+#ifndef LCD_TRACE_SIZE
+#define LCD_TRACE_SIZE 64
+#endif
+
+// Ráfaga más larga que un dispositivo envía sin esperar a mitad (NDTR del DMA del SPI).
+// La cola parte las más largas para no esperar dentro de PendSV.
+#define LCD_DEVICE_BURST_MAX  0xFFFF
+
+// Ejes de la ventana que cambiaron; los demás siguen cargados en el panel
+#define LCD_WINDOW_X  0x01
+#define LCD_WINDOW_Y  0x02
+
+// Destino de las operaciones del driver. Las coordenadas ya vienen recortadas y en
+// columnas de la RAM del panel (el driver aplica el scroll antes de llamar).
+typedef struct {
+    void (*init)(void);                                         // Reset y bus en reposo
+    void (*command)(uint8_t cmd, const uint8_t* params, uint8_t count);
+    void (*window)(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t resend);
+    void (*pixels)(const uint16_t* pixels, uint32_t count);     // Puede volver antes de terminar
+    void (*color)(uint16_t color, uint32_t count);
+    void (*end)(void);
+    void (*flush)(void);                                        // Espera a que termine lo enviado
+    uint8_t (*busy)(void);                                      // Barrera sin esperar
+} LCDDevice;
+
+extern const LCDDevice lcd_parallel_device;
+extern const LCDDevice lcd_trace_device;
+
+#if LCD_BACKEND == LCD_BACKEND_SPI
+extern const LCDDevice lcd_spi_device;
+#endif
+
+// En el host no hay bus: el driver arranca sobre el registro de tráfico
+#ifndef LCD_DEFAULT_DEVICE
+#if LCD_BACKEND == LCD_BACKEND_SPI
+#define LCD_DEFAULT_DEVICE  lcd_spi_device
+#else
+#define LCD_DEFAULT_DEVICE  lcd_parallel_device
+#endif
+#endif
+
+// CASET/PASET de los ejes pedidos y RAMWR, a través de device->command
+void LCDDevice_SendWindow(const LCDDevice* device, uint16_t x0, uint16_t y0,
+                          uint16_t x1, uint16_t y1, uint8_t resend);
+
+// Framebuffer que emula la RAM del panel (150 KB): solo en el host, fuera del firmware.
+// Interpreta los comandos de ventana y de scroll igual que el ILI9341.
+extern const LCDDevice lcd_fb_device;
+
+// Píxel visible en la columna x de pantalla, con el scroll aplicado
+uint16_t LCDFB_GetPixel(int16_t x, int16_t y);
+
+// Registro de tráfico: cuenta y guarda las últimas operaciones y las reenvía al
+// dispositivo enganchado (o a ninguno, para medir sin panel)
+enum {
+    LCD_TRACE_COMMAND,
+    LCD_TRACE_WINDOW,
+    LCD_TRACE_PIXELS,
+    LCD_TRACE_COLOR,
+    LCD_TRACE_END
+};
+
+typedef struct {
+    uint8_t op;
+    uint8_t arg;          // Comando, o ejes reenviados en una ventana
+    uint16_t color;
+    uint16_t x0, y0, x1, y1;
+    uint32_t count;
+} LCDTraceEntry;
+
+typedef struct {
+    uint32_t commands;
+    uint32_t windows;
+    uint32_t pixels;
+    uint32_t bytes;       // Bytes que habrían pasado por el bus del ILI9341
+} LCDTraceStats;
+
+void LCDTrace_Attach(const LCDDevice* target);
+void LCDTrace_Reset(void);
+const LCDTraceStats* LCDTrace_GetStats(void);
+uint16_t LCDTrace_Count(void);
+const LCDTraceEntry* LCDTrace_Entry(uint16_t index);   // 0 = la más antigua guardada
+
+#endif
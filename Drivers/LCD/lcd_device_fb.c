@@ -0,0 +1,126 @@
+#include "lcd_device.h"
+#include "lcd_driver.h"
+
+// RAM del panel tal como la direccionan CASET (x) y PASET (y) en horizontal
+static uint16_t framebuffer[LCD_HEIGHT][LCD_WIDTH];
+
+static uint16_t fb_x0, fb_x1, fb_y0, fb_y1;
+static uint16_t fb_x, fb_y;
+
+static uint16_t fb_scroll_top = 0;
+static uint16_t fb_scroll_lines = LCD_WIDTH;
+static uint16_t fb_scroll_start = 0;
+
+static uint16_t LCD_FBParam16(const uint8_t* params, uint8_t index)
+{
+    return ((uint16_t)params[index] << 8) | params[index + 1];
+}
+
+// Como el panel tras el reset: la RAM conserva lo que tuviera
+static void LCD_FBInit(void)
+{
+    fb_x0 = 0;
+    fb_x1 = LCD_WIDTH - 1;
+    fb_y0 = 0;
+    fb_y1 = LCD_HEIGHT - 1;
+    fb_x = 0;
+    fb_y = 0;
+
+    fb_scroll_top = 0;
+    fb_scroll_lines = LCD_WIDTH;
+    fb_scroll_start = 0;
+}
+
+static void LCD_FBCommand(uint8_t cmd, const uint8_t* params, uint8_t count)
+{
+    switch (cmd) {
+        case LCD_CMD_CASET:
+            if (count < 4) break;
+            fb_x0 = LCD_FBParam16(params, 0);
+            fb_x1 = LCD_FBParam16(params, 2);
+            break;
+        case LCD_CMD_PASET:
+            if (count < 4) break;
+            fb_y0 = LCD_FBParam16(params, 0);
+            fb_y1 = LCD_FBParam16(params, 2);
+            break;
+        case LCD_CMD_RAMWR:
+            fb_x = fb_x0;
+            fb_y = fb_y0;
+            break;
+        case LCD_CMD_VSCRDEF:
+            if (count < 6) break;
+            fb_scroll_top = LCD_FBParam16(params, 0);
+            fb_scroll_lines = LCD_FBParam16(params, 2);
+            break;
+        case LCD_CMD_VSCRSADD:
+            if (count < 2) break;
+            fb_scroll_start = LCD_FBParam16(params, 0);
+            break;
+    }
+}
+
+static void LCD_FBWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t resend)
+{
+    LCDDevice_SendWindow(&lcd_fb_device, x0, y0, x1, y1, resend);
+}
+
+// El puntero recorre la ventana por filas y vuelve al principio al terminarla
+static void LCD_FBWrite(uint16_t color)
+{
+    if (fb_x < LCD_WIDTH && fb_y < LCD_HEIGHT) {
+        framebuffer[fb_y][fb_x] = color;
+    }
+
+    if (++fb_x > fb_x1) {
+        fb_x = fb_x0;
+        if (++fb_y > fb_y1) fb_y = fb_y0;
+    }
+}
+
+static void LCD_FBPixels(const uint16_t* pixels, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        LCD_FBWrite(pixels[i]);
+    }
+}
+
+static void LCD_FBColor(uint16_t color, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        LCD_FBWrite(color);
+    }
+}
+
+static void LCD_FBEnd(void)
+{
+}
+
+static uint8_t LCD_FBBusy(void)
+{
+    return 0;
+}
+
+const LCDDevice lcd_fb_device = {
+    LCD_FBInit,
+    LCD_FBCommand,
+    LCD_FBWindow,
+    LCD_FBPixels,
+    LCD_FBColor,
+    LCD_FBEnd,
+    LCD_FBEnd,
+    LCD_FBBusy
+};
+
+uint16_t LCDFB_GetPixel(int16_t x, int16_t y)
+{
+    if (x < 0 || x >= LCD_WIDTH || y < 0 || y >= LCD_HEIGHT) return 0;
+
+    // Dentro del área de scroll la columna x muestra la línea de RAM desplazada
+    int16_t mx = x;
+    if (fb_scroll_lines > 0 && x >= fb_scroll_top && x < fb_scroll_top + fb_scroll_lines) {
+        mx = fb_scroll_top + (x - fb_scroll_top + fb_scroll_start - fb_scroll_top) % fb_scroll_lines;
+    }
+
+    return framebuffer[y][mx];
+}
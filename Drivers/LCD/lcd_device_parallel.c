@@ -0,0 +1,101 @@
+#include "lcd_bus.h"
+#include "lcd_driver.h"
+
+// Escribir byte en el bus de datos paralelo
+static void LCD_WriteDataBus(uint8_t data)
+{
+    HAL_GPIO_WritePin(LCD_D0_GPIO_Port, LCD_D0_Pin, (data & 0x01) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(LCD_D1_GPIO_Port, LCD_D1_Pin, (data & 0x02) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(LCD_D2_GPIO_Port, LCD_D2_Pin, (data & 0x04) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(LCD_D3_GPIO_Port, LCD_D3_Pin, (data & 0x08) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(LCD_D4_GPIO_Port, LCD_D4_Pin, (data & 0x10) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(LCD_D5_GPIO_Port, LCD_D5_Pin, (data & 0x20) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(LCD_D6_GPIO_Port, LCD_D6_Pin, (data & 0x40) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(LCD_D7_GPIO_Port, LCD_D7_Pin, (data & 0x80) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+
+    LCD_WR_LOW();
+    __NOP(); __NOP(); __NOP(); __NOP();
+    LCD_WR_HIGH();
+    __NOP(); __NOP();
+}
+
+static void LCD_ParallelInit(void)
+{
+    LCD_RD_HIGH();
+    LCD_CS_HIGH();
+
+    // Reset por hardware: pulso de al menos 10 us
+    LCD_RST_LOW();
+    HAL_Delay(1);
+    LCD_RST_HIGH();
+}
+
+static void LCD_ParallelCommand(uint8_t cmd, const uint8_t* params, uint8_t count)
+{
+    LCD_CS_LOW();
+    LCD_RS_LOW();
+    LCD_WriteDataBus(cmd);
+    LCD_RS_HIGH();
+
+    for (uint8_t i = 0; i < count; i++) {
+        LCD_WriteDataBus(params[i]);
+    }
+
+    LCD_CS_HIGH();
+}
+
+static void LCD_ParallelWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t resend)
+{
+    LCDDevice_SendWindow(&lcd_parallel_device, x0, y0, x1, y1, resend);
+}
+
+static void LCD_ParallelPixels(const uint16_t* pixels, uint32_t count)
+{
+    LCD_CS_LOW();
+    LCD_RS_HIGH();
+
+    for (uint32_t i = 0; i < count; i++) {
+        LCD_WriteDataBus(pixels[i] >> 8);
+        LCD_WriteDataBus(pixels[i] & 0xFF);
+    }
+}
+
+static void LCD_ParallelColor(uint16_t color, uint32_t count)
+{
+    uint8_t hi = color >> 8;
+    uint8_t lo = color & 0xFF;
+
+    LCD_CS_LOW();
+    LCD_RS_HIGH();
+
+    for (uint32_t i = 0; i < count; i++) {
+        LCD_WriteDataBus(hi);
+        LCD_WriteDataBus(lo);
+    }
+}
+
+static void LCD_ParallelEnd(void)
+{
+    LCD_CS_HIGH();
+}
+
+// Por GPIO todo es síncrono: la transferencia termina antes de volver
+static void LCD_ParallelFlush(void)
+{
+}
+
+static uint8_t LCD_ParallelBusy(void)
+{
+    return 0;
+}
+
+const LCDDevice lcd_parallel_device = {
+    LCD_ParallelInit,
+    LCD_ParallelCommand,
+    LCD_ParallelWindow,
+    LCD_ParallelPixels,
+    LCD_ParallelColor,
+    LCD_ParallelEnd,
+    LCD_ParallelFlush,
+    LCD_ParallelBusy
+};
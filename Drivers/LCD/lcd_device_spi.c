@@ -0,0 +1,221 @@
+#include "lcd_bus.h"
+
+#if LCD_BACKEND == LCD_BACKEND_SPI
+
+#include "lcd_driver.h"
+#include "lcd_queue.h"
+
+extern SPI_HandleTypeDef hspi1;
+
+DMA_HandleTypeDef hdma_spi1_tx;
+
+// NDTR del DMA cuenta como mucho 65535 tramas
+#define LCD_SPI_DMA_MAX  LCD_DEVICE_BURST_MAX
+
+// Por debajo de esto sale más barato escribir DR que programar el DMA
+#define LCD_SPI_DMA_MIN  32
+
+// En el host, el doble del SPI captura lo escrito en DR y termina el DMA al esperarlo
+#ifndef LCD_SPI_WRITE_DR
+#define LCD_SPI_WRITE_DR(value)  (hspi1.Instance->DR = (value))
+#endif
+
+#ifndef LCD_SPI_DMA_POLL
+#define LCD_SPI_DMA_POLL()
+#endif
+
+static volatile uint8_t dma_busy = 0;
+
+// Fuente fija (sin incremento de memoria) para las ráfagas de un solo color
+static uint16_t dma_color;
+
+// Espera a que el último bit haya salido: D/C y CS no pueden cambiar antes
+static void LCD_SpiWaitIdle(void)
+{
+    // Esperar al DMA desde una interrupción para al bucle principal toda la ráfaga.
+    // La cola no llega aquí con el DMA en marcha: parte las ráfagas largas.
+    assert_param(!dma_busy || __get_IPSR() == 0);
+
+    while (dma_busy) {
+        LCD_SPI_DMA_POLL();
+    }
+    while (!(hspi1.Instance->SR & SPI_SR_TXE)) {
+    }
+    while (hspi1.Instance->SR & SPI_SR_BSY) {
+    }
+
+    // En modo de dos líneas lo recibido por MISO se descarta
+    __HAL_SPI_CLEAR_OVRFLAG(&hspi1);
+}
+
+// Comandos y parámetros en tramas de 8 bits, píxeles en tramas de 16 bits
+static void LCD_SpiFrameSize(uint32_t size)
+{
+    if (hspi1.Init.DataSize == size) return;
+
+    // DFF solo se puede cambiar con el periférico parado
+    __HAL_SPI_DISABLE(&hspi1);
+    if (size == SPI_DATASIZE_16BIT) {
+        hspi1.Instance->CR1 |= SPI_CR1_DFF;
+    } else {
+        hspi1.Instance->CR1 &= ~SPI_CR1_DFF;
+    }
+    hspi1.Init.DataSize = size;
+    __HAL_SPI_ENABLE(&hspi1);
+}
+
+static void LCD_SpiWrite(uint16_t value)
+{
+    while (!(hspi1.Instance->SR & SPI_SR_TXE)) {
+    }
+    LCD_SPI_WRITE_DR(value);
+}
+
+static void LCD_SpiStartDMA(const uint16_t* src, uint16_t count, uint8_t increment)
+{
+    // MINC se puede tocar mientras el stream está parado; HAL no lo reescribe al arrancar
+    if (increment) {
+        hdma_spi1_tx.Instance->CR |= DMA_SxCR_MINC;
+    } else {
+        hdma_spi1_tx.Instance->CR &= ~DMA_SxCR_MINC;
+    }
+
+    dma_busy = 1;
+    if (HAL_SPI_Transmit_DMA(&hspi1, (const uint8_t*)src, count) != HAL_OK) {
+        dma_busy = 0;
+    }
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi)
+{
+    if (hspi != &hspi1) return;
+
+    dma_busy = 0;
+
+    // La cola sigue con la operación siguiente en cuanto el bus queda libre
+    LCDQueue_Resume();
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi)
+{
+    if (hspi != &hspi1) return;
+
+    dma_busy = 0;
+    LCDQueue_Resume();
+}
+
+static void LCD_SpiInit(void)
+{
+    LCD_CS_HIGH();
+    LCD_RS_HIGH();
+    LCD_SpiFrameSize(SPI_DATASIZE_8BIT);
+    __HAL_SPI_ENABLE(&hspi1);
+
+    LCD_RST_LOW();
+    HAL_Delay(1);
+    LCD_RST_HIGH();
+}
+
+static void LCD_SpiCommand(uint8_t cmd, const uint8_t* params, uint8_t count)
+{
+    LCD_SpiWaitIdle();
+    LCD_SpiFrameSize(SPI_DATASIZE_8BIT);
+
+    LCD_CS_LOW();
+    LCD_RS_LOW();
+    LCD_SpiWrite(cmd);
+    LCD_SpiWaitIdle();
+    LCD_RS_HIGH();
+
+    for (uint8_t i = 0; i < count; i++) {
+        LCD_SpiWrite(params[i]);
+    }
+
+    LCD_SpiWaitIdle();
+    LCD_CS_HIGH();
+}
+
+static void LCD_SpiWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t resend)
+{
+    LCDDevice_SendWindow(&lcd_spi_device, x0, y0, x1, y1, resend);
+}
+
+static void LCD_SpiBeginPixels(void)
+{
+    LCD_SpiWaitIdle();
+    LCD_SpiFrameSize(SPI_DATASIZE_16BIT);
+
+    LCD_CS_LOW();
+    LCD_RS_HIGH();
+}
+
+// Solo el último tramo queda en curso al volver: el buffer se lee hasta el fin del DMA.
+// Los tramos anteriores se esperan aquí, así que desde la cola llegan como mucho
+// LCD_DEVICE_BURST_MAX píxeles.
+static void LCD_SpiPixels(const uint16_t* pixels, uint32_t count)
+{
+    LCD_SpiBeginPixels();
+
+    if (count < LCD_SPI_DMA_MIN) {
+        for (uint32_t i = 0; i < count; i++) {
+            LCD_SpiWrite(pixels[i]);
+        }
+        return;
+    }
+
+    while (count > LCD_SPI_DMA_MAX) {
+        LCD_SpiStartDMA(pixels, LCD_SPI_DMA_MAX, 1);
+        LCD_SpiWaitIdle();
+        pixels += LCD_SPI_DMA_MAX;
+        count -= LCD_SPI_DMA_MAX;
+    }
+
+    LCD_SpiStartDMA(pixels, count, 1);
+}
+
+// El color vive en dma_color, así que la ráfaga también puede seguir en curso al volver
+static void LCD_SpiColor(uint16_t color, uint32_t count)
+{
+    LCD_SpiBeginPixels();
+
+    if (count < LCD_SPI_DMA_MIN) {
+        for (uint32_t i = 0; i < count; i++) {
+            LCD_SpiWrite(color);
+        }
+        return;
+    }
+
+    dma_color = color;
+
+    while (count > LCD_SPI_DMA_MAX) {
+        LCD_SpiStartDMA(&dma_color, LCD_SPI_DMA_MAX, 0);
+        LCD_SpiWaitIdle();
+        count -= LCD_SPI_DMA_MAX;
+    }
+
+    LCD_SpiStartDMA(&dma_color, count, 0);
+}
+
+static void LCD_SpiEnd(void)
+{
+    LCD_SpiWaitIdle();
+    LCD_CS_HIGH();
+}
+
+static uint8_t LCD_SpiBusy(void)
+{
+    return dma_busy;
+}
+
+const LCDDevice lcd_spi_device = {
+    LCD_SpiInit,
+    LCD_SpiCommand,
+    LCD_SpiWindow,
+    LCD_SpiPixels,
+    LCD_SpiColor,
+    LCD_SpiEnd,
+    LCD_SpiWaitIdle,
+    LCD_SpiBusy
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "lcd_device.h"
+
+static const LCDDevice* trace_target = 0;
+static LCDTraceEntry trace[LCD_TRACE_SIZE];
+static uint16_t trace_next = 0;
+static uint16_t trace_count = 0;
+static LCDTraceStats trace_stats;
+
+static LCDTraceEntry* LCDTrace_Record(uint8_t op)
+{
+    LCDTraceEntry* entry = &trace[trace_next];
+
+    trace_next = (trace_next + 1) % LCD_TRACE_SIZE;
+    if (trace_count < LCD_TRACE_SIZE) trace_count++;
+
+    entry->op = op;
+    entry->arg = 0;
+    entry->color = 0;
+    entry->x0 = 0;
+    entry->y0 = 0;
+    entry->x1 = 0;
+    entry->y1 = 0;
+    entry->count = 0;
+    return entry;
+}
+
+static void LCDTrace_Init(void)
+{
+    if (trace_target) trace_target->init();
+}
+
+static void LCDTrace_Command(uint8_t cmd, const uint8_t* params, uint8_t count)
+{
+    LCDTraceEntry* entry = LCDTrace_Record(LCD_TRACE_COMMAND);
+
+    entry->arg = cmd;
+    entry->count = count;
+    trace_stats.commands++;
+    trace_stats.bytes += 1 + count;
+
+    if (trace_target) trace_target->command(cmd, params, count);
+}
+
+static void LCDTrace_Window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t resend)
+{
+    LCDTraceEntry* entry = LCDTrace_Record(LCD_TRACE_WINDOW);
+
+    entry->arg = resend;
+    entry->x0 = x0;
+    entry->y0 = y0;
+    entry->x1 = x1;
+    entry->y1 = y1;
+    trace_stats.windows++;
+
+    // CASET y PASET con 4 parámetros cada uno, más RAMWR
+    if (resend & LCD_WINDOW_X) trace_stats.bytes += 5;
+    if (resend & LCD_WINDOW_Y) trace_stats.bytes += 5;
+    trace_stats.bytes++;
+
+    if (trace_target) trace_target->window(x0, y0, x1, y1, resend);
+}
+
+static void LCDTrace_Pixels(const uint16_t* pixels, uint32_t count)
+{
+    LCDTraceEntry* entry = LCDTrace_Record(LCD_TRACE_PIXELS);
+
+    entry->count = count;
+    trace_stats.pixels += count;
+    trace_stats.bytes += count * 2;
+
+    if (trace_target) trace_target->pixels(pixels, count);
+}
+
+static void LCDTrace_Color(uint16_t color, uint32_t count)
+{
+    LCDTraceEntry* entry = LCDTrace_Record(LCD_TRACE_COLOR);
+
+    entry->color = color;
+    entry->count = count;
+    trace_stats.pixels += count;
+    trace_stats.bytes += count * 2;
+
+    if (trace_target) trace_target->color(color, count);
+}
+
+static void LCDTrace_End(void)
+{
+    LCDTrace_Record(LCD_TRACE_END);
+
+    if (trace_target) trace_target->end();
+}
+
+static void LCDTrace_Flush(void)
+{
+    if (trace_target) trace_target->flush();
+}
+
+static uint8_t LCDTrace_Busy(void)
+{
+    return trace_target ? trace_target->busy() : 0;
+}
+
+const LCDDevice lcd_trace_device = {
+    LCDTrace_Init,
+    LCDTrace_Command,
+    LCDTrace_Window,
+    LCDTrace_Pixels,
+    LCDTrace_Color,
+    LCDTrace_End,
+    LCDTrace_Flush,
+    LCDTrace_Busy
+};
+
+// Con target = 0 el registro hace de panel nulo: solo cuenta
+void LCDTrace_Attach(const LCDDevice* target)
+{
+    trace_target = (target == &lcd_trace_device) ? 0 : target;
+}
+
+void LCDTrace_Reset(void)
+{
+    trace_next = 0;
+    trace_count = 0;
+    trace_stats.commands = 0;
+    trace_stats.windows = 0;
+    trace_stats.pixels = 0;
+    trace_stats.bytes = 0;
+}
+
+const LCDTraceStats* LCDTrace_GetStats(void)
+{
+    return &trace_stats;
+}
+
+uint16_t LCDTrace_Count(void)
+{
+    return trace_count;
+}
+
+const LCDTraceEntry* LCDTrace_Entry(uint16_t index)
+{
+    if (index >= trace_count) return 0;
+
+    uint16_t first = (trace_next + LCD_TRACE_SIZE - trace_count) % LCD_TRACE_SIZE;
+    return &trace[(first + index) % LCD_TRACE_SIZE];
+}
@@ -1,251 +1,393 @@
 #include "lcd_driver.h"
+#include "main.h"
 #include <stdlib.h>
 
 static uint16_t lcd_width = LCD_WIDTH;
 static uint16_t lcd_height = LCD_HEIGHT;
 
-// Escribir byte en el bus de datos paralelo
-static void LCD_WriteDataBus(uint8_t data)
-{
-    HAL_GPIO_WritePin(LCD_D0_GPIO_Port, LCD_D0_Pin, (data & 0x01) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_D1_GPIO_Port, LCD_D1_Pin, (data & 0x02) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_D2_GPIO_Port, LCD_D2_Pin, (data & 0x04) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_D3_GPIO_Port, LCD_D3_Pin, (data & 0x08) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_D4_GPIO_Port, LCD_D4_Pin, (data & 0x10) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_D5_GPIO_Port, LCD_D5_Pin, (data & 0x20) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_D6_GPIO_Port, LCD_D6_Pin, (data & 0x40) ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(LCD_D7_GPIO_Port, LCD_D7_Pin, (data & 0x80) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+// Ventana CASET/PASET activa y posición del puntero de RAMWR, tal como las ve el panel
+static uint8_t window_valid = 0;
+static uint8_t cursor_valid = 0;
+static uint16_t win_x0, win_x1, win_y0, win_y1;
+static uint16_t cursor_x, cursor_y;
 
-    LCD_WR_LOW();
-    __NOP(); __NOP(); __NOP(); __NOP();
-    LCD_WR_HIGH();
-    __NOP(); __NOP();
-}
+static LCDBusStats bus_stats;
 
-static void LCD_WriteCommand(uint8_t cmd)
-{
-    LCD_CS_LOW();
-    LCD_RS_LOW();
-    LCD_WriteDataBus(cmd);
-    LCD_CS_HIGH();
-}
+// Scroll vertical del panel: en horizontal (MV = 1) desplaza las columnas de pantalla
+static uint16_t scroll_top = 0;
+static uint16_t scroll_lines = LCD_WIDTH;
+static uint16_t scroll_offset = 0;
 
-static void LCD_WriteData(uint8_t data)
+static const LCDDevice* device = &LCD_DEFAULT_DEVICE;
+
+// Cualquier comando corta la escritura en RAM y puede mover la ventana
+static void LCD_WriteCommand(uint8_t cmd, const uint8_t* params, uint8_t count)
 {
-    LCD_CS_LOW();
-    LCD_RS_HIGH();
-    LCD_WriteDataBus(data);
-    LCD_CS_HIGH();
+    window_valid = 0;
+    cursor_valid = 0;
+    bus_stats.commands++;
+    bus_stats.bytes += 1 + count;
+
+    device->command(cmd, params, count);
 }
 
 static void LCD_WriteData16(uint16_t data)
 {
-    LCD_CS_LOW();
-    LCD_RS_HIGH();
-    LCD_WriteDataBus(data >> 8);
-    LCD_WriteDataBus(data & 0xFF);
-    LCD_CS_HIGH();
+    bus_stats.bytes += 2;
+    device->color(data, 1);
+    device->end();
 }
 
 static void LCD_SetWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 {
+    uint8_t resend = 0;
+
     if (x1 >= lcd_width) x1 = lcd_width - 1;
     if (y1 >= lcd_height) y1 = lcd_height - 1;
 
-    LCD_WriteCommand(LCD_CMD_CASET);
-    LCD_WriteData(x0 >> 8);
-    LCD_WriteData(x0 & 0xFF);
-    LCD_WriteData(x1 >> 8);
-    LCD_WriteData(x1 & 0xFF);
+    // Solo se reenvía el eje que cambió
+    if (!window_valid || x0 != win_x0 || x1 != win_x1) {
+        resend |= LCD_WINDOW_X;
+        bus_stats.commands++;
+        bus_stats.bytes += 5;
+    } else {
+        bus_stats.caset_skipped++;
+    }
+
+    if (!window_valid || y0 != win_y0 || y1 != win_y1) {
+        resend |= LCD_WINDOW_Y;
+        bus_stats.commands++;
+        bus_stats.bytes += 5;
+    } else {
+        bus_stats.paset_skipped++;
+    }
 
-    LCD_WriteCommand(LCD_CMD_PASET);
-    LCD_WriteData(y0 >> 8);
-    LCD_WriteData(y0 & 0xFF);
-    LCD_WriteData(y1 >> 8);
-    LCD_WriteData(y1 & 0xFF);
+    // RAMWR
+    bus_stats.commands++;
+    bus_stats.bytes++;
 
-    LCD_WriteCommand(LCD_CMD_RAMWR);
+    device->window(x0, y0, x1, y1, resend);
+
+    win_x0 = x0;
+    win_x1 = x1;
+    win_y0 = y0;
+    win_y1 = y1;
+    window_valid = 1;
+
+    cursor_x = x0;
+    cursor_y = y0;
+    cursor_valid = 1;
 }
 
-void LCD_Init(void)
+void LCDDevice_SendWindow(const LCDDevice* dev, uint16_t x0, uint16_t y0,
+                          uint16_t x1, uint16_t y1, uint8_t resend)
 {
-    LCD_RD_HIGH();
-    LCD_CS_HIGH();
-
-    // Reset Hardware
-    LCD_RST_HIGH();
-    HAL_Delay(10);
-    LCD_RST_LOW();
-    HAL_Delay(20);
-    LCD_RST_HIGH();
-    HAL_Delay(120);
-
-    // Software Reset
-    LCD_WriteCommand(0x01);
-    HAL_Delay(150);
-
-    // Power Control A
-    LCD_WriteCommand(0xCB);
-    LCD_WriteData(0x39);
-    LCD_WriteData(0x2C);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x34);
-    LCD_WriteData(0x02);
-
-    // Power Control B
-    LCD_WriteCommand(0xCF);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0xC1);
-    LCD_WriteData(0x30);
-
-    // Driver timing control A
-    LCD_WriteCommand(0xE8);
-    LCD_WriteData(0x85);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x78);
-
-    // Driver timing control B
-    LCD_WriteCommand(0xEA);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x00);
-
-    // Power on sequence control
-    LCD_WriteCommand(0xED);
-    LCD_WriteData(0x64);
-    LCD_WriteData(0x03);
-    LCD_WriteData(0x12);
-    LCD_WriteData(0x81);
-
-    // Pump ratio control
-    LCD_WriteCommand(0xF7);
-    LCD_WriteData(0x20);
-
-    // Power Control 1
-    LCD_WriteCommand(0xC0);
-    LCD_WriteData(0x23);
-
-    // Power Control 2
-    LCD_WriteCommand(0xC1);
-    LCD_WriteData(0x10);
-
-    // VCOM Control 1
-    LCD_WriteCommand(0xC5);
-    LCD_WriteData(0x3e);
-    LCD_WriteData(0x28);
-
-    // VCOM Control 2
-    LCD_WriteCommand(0xC7);
-    LCD_WriteData(0x86);
-
-    // Memory Access Control
-    LCD_WriteCommand(LCD_CMD_MADCTL);
-    LCD_WriteData(0x28);
-
-    // Pixel Format Set
-    LCD_WriteCommand(LCD_CMD_COLMOD);
-    LCD_WriteData(0x55);
-
-    // Frame Rate Control
-    LCD_WriteCommand(0xB1);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x1B);
-
-    // Display Function Control
-    LCD_WriteCommand(0xB6);
-    LCD_WriteData(0x0A);
-    LCD_WriteData(0xA2);
-    LCD_WriteData(0x27);
-    LCD_WriteData(0x00);
-
-    // Enable 3 gamma control
-    LCD_WriteCommand(0xF2);
-    LCD_WriteData(0x00);
-
-    // Gamma Set
-    LCD_WriteCommand(0x26);
-    LCD_WriteData(0x01);
-
-    // Positive Gamma Correction
-    LCD_WriteCommand(0xE0);
-    LCD_WriteData(0x0F);
-    LCD_WriteData(0x31);
-    LCD_WriteData(0x2B);
-    LCD_WriteData(0x0C);
-    LCD_WriteData(0x0E);
-    LCD_WriteData(0x08);
-    LCD_WriteData(0x4E);
-    LCD_WriteData(0xF1);
-    LCD_WriteData(0x37);
-    LCD_WriteData(0x07);
-    LCD_WriteData(0x10);
-    LCD_WriteData(0x03);
-    LCD_WriteData(0x0E);
-    LCD_WriteData(0x09);
-    LCD_WriteData(0x00);
-
-    // Negative Gamma Correction
-    LCD_WriteCommand(0xE1);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x0E);
-    LCD_WriteData(0x14);
-    LCD_WriteData(0x03);
-    LCD_WriteData(0x11);
-    LCD_WriteData(0x07);
-    LCD_WriteData(0x31);
-    LCD_WriteData(0xC1);
-    LCD_WriteData(0x48);
-    LCD_WriteData(0x08);
-    LCD_WriteData(0x0F);
-    LCD_WriteData(0x0C);
-    LCD_WriteData(0x31);
-    LCD_WriteData(0x36);
-    LCD_WriteData(0x0F);
-
-    // Column Address Set
-    LCD_WriteCommand(LCD_CMD_CASET);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x00);
-    LCD_WriteData((lcd_width - 1) >> 8);
-    LCD_WriteData((lcd_width - 1) & 0xFF);
-
-    // Page Address Set
-    LCD_WriteCommand(LCD_CMD_PASET);
-    LCD_WriteData(0x00);
-    LCD_WriteData(0x00);
-    LCD_WriteData((lcd_height - 1) >> 8);
-    LCD_WriteData((lcd_height - 1) & 0xFF);
-
-    // Sleep Out
-    LCD_WriteCommand(LCD_CMD_SLPOUT);
-    HAL_Delay(120);
-
-    // Display ON
-    LCD_WriteCommand(LCD_CMD_DISPON);
-    HAL_Delay(50);
-
-    // Limpieza inicial
-    for (int i = 0; i < 3; i++) {
-        LCD_Clear(COLOR_BLACK);
-        HAL_Delay(20);
+    uint8_t params[4];
+
+    if (resend & LCD_WINDOW_X) {
+        params[0] = x0 >> 8;
+        params[1] = x0 & 0xFF;
+        params[2] = x1 >> 8;
+        params[3] = x1 & 0xFF;
+        dev->command(LCD_CMD_CASET, params, 4);
     }
+
+    if (resend & LCD_WINDOW_Y) {
+        params[0] = y0 >> 8;
+        params[1] = y0 & 0xFF;
+        params[2] = y1 >> 8;
+        params[3] = y1 & 0xFF;
+        dev->command(LCD_CMD_PASET, params, 4);
+    }
+
+    dev->command(LCD_CMD_RAMWR, 0, 0);
+}
+
+// El panel avanza por columnas dentro de la ventana y vuelve al inicio al llegar al final
+static void LCD_AdvanceCursor(uint32_t count)
+{
+    if (!cursor_valid) return;
+
+    uint32_t w = win_x1 - win_x0 + 1;
+    uint32_t h = win_y1 - win_y0 + 1;
+    uint32_t pos = (uint32_t)(cursor_y - win_y0) * w + (cursor_x - win_x0) + count;
+
+    pos %= w * h;
+    cursor_x = win_x0 + pos % w;
+    cursor_y = win_y0 + pos / w;
+}
+
+// Secuencia de arranque: comando, nº de parámetros (| LCD_INIT_DELAY si sigue una
+// espera en ms) y parámetros. Esperas mínimas según la hoja de datos del ILI9341.
+#define LCD_INIT_DELAY        0x80
+#define LCD_INIT_SINCE_RESET  0xFF   // Pseudo-comando: esperar hasta N ms desde el reset
+
+static const uint8_t lcd_init_table[] = {
+    0xCB, 5, 0x39, 0x2C, 0x00, 0x34, 0x02,          // Power Control A
+    0xCF, 3, 0x00, 0xC1, 0x30,                      // Power Control B
+    0xE8, 3, 0x85, 0x00, 0x78,                      // Driver timing control A
+    0xEA, 2, 0x00, 0x00,                            // Driver timing control B
+    0xED, 4, 0x64, 0x03, 0x12, 0x81,                // Power on sequence control
+    0xF7, 1, 0x20,                                  // Pump ratio control
+    0xC0, 1, 0x23,                                  // Power Control 1
+    0xC1, 1, 0x10,                                  // Power Control 2
+    0xC5, 2, 0x3E, 0x28,                            // VCOM Control 1
+    0xC7, 1, 0x86,                                  // VCOM Control 2
+    LCD_CMD_MADCTL, 1, 0x28,                        // Memory Access Control
+    LCD_CMD_COLMOD, 1, 0x55,                        // Pixel Format Set
+    0xB1, 2, 0x00, 0x1B,                            // Frame Rate Control
+    0xB6, 4, 0x0A, 0xA2, 0x27, 0x00,                // Display Function Control
+    0xF2, 1, 0x00,                                  // Enable 3 gamma control
+    0x26, 1, 0x01,                                  // Gamma Set
+    LCD_CMD_WRCTRLD, 1, 0x2C,                       // Brillo por WRDISBV con atenuación suave
+    LCD_CMD_WRDISBV, 1, 0xFF,                       // Brillo máximo
+    LCD_INIT_SINCE_RESET, 1, 120,                   // Sleep Out no antes de 120 ms tras el reset
+    LCD_CMD_SLPOUT, LCD_INIT_DELAY, 5,              // Sleep Out: 5 ms hasta el siguiente comando
+};
+
+// Curvas de gamma de fábrica (se cargan en LCD_Init tras la tabla)
+const uint8_t lcd_gamma_positive[LCD_GAMMA_LENGTH] = {
+    0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1,
+    0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00
+};
+
+const uint8_t lcd_gamma_negative[LCD_GAMMA_LENGTH] = {
+    0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1,
+    0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F
+};
+
+static void LCD_RunInitTable(const uint8_t* table, uint16_t length, uint32_t reset_tick)
+{
+    uint16_t i = 0;
+
+    while (i < length) {
+        uint8_t cmd = table[i++];
+        uint8_t count = table[i] & ~LCD_INIT_DELAY;
+        uint8_t delay = table[i++] & LCD_INIT_DELAY;
+
+        if (cmd == LCD_INIT_SINCE_RESET) {
+            uint32_t elapsed = HAL_GetTick() - reset_tick;
+            if (elapsed < table[i]) HAL_Delay(table[i] - elapsed);
+            i += count;
+            continue;
+        }
+
+        LCD_WriteCommand(cmd, &table[i], count);
+        i += count;
+
+        if (delay) HAL_Delay(table[i++]);
+    }
+}
+
+// Deja el panel configurado y fuera de sleep, con la pantalla apagada: la RAM tiene
+// basura hasta que se envíe el primer frame completo (ver LCD_DisplayOn)
+void LCD_Init(void)
+{
+    window_valid = 0;
+    cursor_valid = 0;
+
+    // Tras el reset el área de scroll es la pantalla completa sin desplazamiento
+    scroll_top = 0;
+    scroll_lines = lcd_width;
+    scroll_offset = 0;
+
+    // Reset por hardware y 5 ms hasta el primer comando.
+    // Equivale al Software Reset, que por eso ya no se envía.
+    device->init();
+    uint32_t reset_tick = HAL_GetTick();
+    HAL_Delay(5);
+
+    LCD_RunInitTable(lcd_init_table, sizeof(lcd_init_table), reset_tick);
+    LCD_SetGamma(0, 0);
+}
+
+void LCD_DisplayOn(void)
+{
+    LCD_WriteCommand(LCD_CMD_DISPON, 0, 0);
+}
+
+void LCD_DisplayOff(void)
+{
+    LCD_WriteCommand(LCD_CMD_DISPOFF, 0, 0);
+}
+
+void LCD_SetInversion(uint8_t on)
+{
+    LCD_WriteCommand(on ? LCD_CMD_INVON : LCD_CMD_INVOFF, 0, 0);
+}
+
+// Solo tiene efecto si la retroiluminación sigue la salida LEDPWM del controlador
+void LCD_SetBrightness(uint8_t level)
+{
+    LCD_WriteCommand(LCD_CMD_WRDISBV, &level, 1);
+}
+
+// 15 parámetros por polaridad; 0 restaura la curva de fábrica
+void LCD_SetGamma(const uint8_t* positive, const uint8_t* negative)
+{
+    LCD_WriteCommand(LCD_CMD_PGAMCTRL, positive ? positive : lcd_gamma_positive, LCD_GAMMA_LENGTH);
+    LCD_WriteCommand(LCD_CMD_NGAMCTRL, negative ? negative : lcd_gamma_negative, LCD_GAMMA_LENGTH);
 }
 
 void LCD_Clear(uint16_t color)
 {
+    // Pantalla completa: no depende del scroll
     LCD_SetWindow(0, 0, lcd_width - 1, lcd_height - 1);
+    LCD_PushColor(color, (uint32_t)lcd_width * lcd_height);
+    LCD_EndPixels();
+}
 
-    LCD_CS_LOW();
-    LCD_RS_HIGH();
+// Área de scroll entre dos franjas fijas (columnas a la izquierda y a la derecha)
+void LCD_SetScrollArea(uint16_t top_fixed, uint16_t bottom_fixed)
+{
+    scroll_top = top_fixed;
+    scroll_lines = lcd_width - top_fixed - bottom_fixed;
+    scroll_offset = 0;
+
+    uint8_t params[6] = {
+        top_fixed >> 8, top_fixed & 0xFF,
+        scroll_lines >> 8, scroll_lines & 0xFF,
+        bottom_fixed >> 8, bottom_fixed & 0xFF
+    };
+    LCD_WriteCommand(LCD_CMD_VSCRDEF, params, 6);
+
+    LCD_SetScroll(0);
+}
+
+// Un solo comando: la columna x de pantalla pasa a mostrar la columna x + offset de la RAM
+void LCD_SetScroll(uint16_t offset)
+{
+    if (scroll_lines == 0) return;
+
+    scroll_offset = offset % scroll_lines;
+    uint16_t start = scroll_top + scroll_offset;
+
+    uint8_t params[2] = { start >> 8, start & 0xFF };
+    LCD_WriteCommand(LCD_CMD_VSCRSADD, params, 2);
+}
+
+uint16_t LCD_GetScroll(void)
+{
+    return scroll_offset;
+}
+
+// Columna de la RAM del panel que se ve en la columna x de pantalla
+int16_t LCD_MapX(int16_t x)
+{
+    if (scroll_offset == 0 || x < scroll_top || x >= scroll_top + scroll_lines) return x;
+
+    int16_t mx = x + scroll_offset;
+    if (mx >= scroll_top + scroll_lines) mx -= scroll_lines;
+    return mx;
+}
+
+// Columnas desde x que quedan contiguas en la RAM antes de que el scroll dé la vuelta
+int16_t LCD_ScrollSpan(int16_t x, int16_t w)
+{
+    if (scroll_offset == 0 || x >= scroll_top + scroll_lines) return w;
+
+    // La franja fija de la izquierda termina donde empieza el área de scroll
+    if (x < scroll_top) return (x + w > scroll_top) ? scroll_top - x : w;
+
+    int16_t to_wrap = scroll_top + scroll_lines - LCD_MapX(x);
+    int16_t to_end = scroll_top + scroll_lines - x;
+
+    if (to_wrap < w && to_wrap < to_end) return to_wrap;
+    return (to_end < w) ? to_end : w;
+}
+
+// Escritura en ráfaga: una ventana y luego píxeles seguidos sin reenviar CASET/PASET.
+// La ventana no debe cruzar el punto de vuelta del scroll (ver LCD_ScrollSpan).
+void LCD_BeginPixels(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    int16_t mx0 = LCD_MapX(x0);
+
+    LCD_SetWindow(mx0, y0, mx0 + (x1 - x0), y1);
+}
+
+void LCD_PushPixels(const uint16_t* pixels, uint32_t count)
+{
+    bus_stats.bytes += count * 2;
+    device->pixels(pixels, count);
+    device->flush();
+    LCD_AdvanceCursor(count);
+}
+
+void LCD_PushColor(uint16_t color, uint32_t count)
+{
+    bus_stats.bytes += count * 2;
+    device->color(color, count);
+    LCD_AdvanceCursor(count);
+}
+
+void LCD_StartPixels(const uint16_t* pixels, uint32_t count)
+{
+    bus_stats.bytes += count * 2;
+    device->pixels(pixels, count);
+    LCD_AdvanceCursor(count);
+}
+
+uint8_t LCD_Busy(void)
+{
+    return device->busy();
+}
+
+void LCD_EndPixels(void)
+{
+    device->end();
+}
+
+// El cambio vale para todo lo que se dibuje después: la cola debe estar vacía
+void LCD_SetDevice(const LCDDevice* dev)
+{
+    device->flush();
+    device = dev ? dev : &LCD_DEFAULT_DEVICE;
+    window_valid = 0;
+    cursor_valid = 0;
+}
+
+const LCDDevice* LCD_GetDevice(void)
+{
+    return device;
+}
 
-    uint8_t hi = color >> 8;
-    uint8_t lo = color & 0xFF;
+void LCD_DrawBitmap(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels)
+{
+    int16_t stride = w;
 
-    for (uint32_t i = 0; i < (uint32_t)lcd_width * lcd_height; i++) {
-        LCD_WriteDataBus(hi);
-        LCD_WriteDataBus(lo);
+    if (x >= lcd_width || y >= lcd_height) return;
+    if (x < 0) { pixels -= x; w += x; x = 0; }
+    if (y < 0) { pixels -= (int32_t)y * stride; h += y; y = 0; }
+    if (x + w > lcd_width) w = lcd_width - x;
+    if (y + h > lcd_height) h = lcd_height - y;
+    if (w <= 0 || h <= 0) return;
+
+    // Con scroll, las columnas tras el punto de vuelta van en otra ventana
+    int16_t span = LCD_ScrollSpan(x, w);
+    while (span < w) {
+        LCD_BeginPixels(x, y, x + span - 1, y + h - 1);
+        for (int16_t row = 0; row < h; row++) {
+            LCD_PushPixels(pixels + (int32_t)row * stride, span);
+        }
+        LCD_EndPixels();
+
+        pixels += span;
+        x += span;
+        w -= span;
+        span = LCD_ScrollSpan(x, w);
+    }
+
+    LCD_BeginPixels(x, y, x + w - 1, y + h - 1);
+
+    if (w == stride) {
+        LCD_PushPixels(pixels, (uint32_t)w * h);
+    } else {
+        for (int16_t row = 0; row < h; row++) {
+            LCD_PushPixels(pixels + (int32_t)row * stride, w);
+        }
     }
 
-    LCD_CS_HIGH();
+    LCD_EndPixels();
 }
 
 void LCD_DrawPixel(int16_t x, int16_t y, uint16_t color)
@@ -253,8 +395,32 @@ void LCD_DrawPixel(int16_t x, int16_t y, uint16_t color)
     if (x < 0 || x >= lcd_width || y < 0 || y >= lcd_height)
         return;
 
-    LCD_SetWindow(x, y, x, y);
+    x = LCD_MapX(x);
+
+    // Píxel siguiente al último escrito: el panel ya apunta ahí
+    if (cursor_valid && x == cursor_x && y == cursor_y) {
+        bus_stats.pixels_streamed++;
+    } else {
+        // Ventana hasta el borde para que los píxeles consecutivos sigan sin reposicionar
+        LCD_SetWindow(x, y, lcd_width - 1, lcd_height - 1);
+    }
+
     LCD_WriteData16(color);
+    LCD_AdvanceCursor(1);
+}
+
+const LCDBusStats* LCD_GetBusStats(void)
+{
+    return &bus_stats;
+}
+
+void LCD_ResetBusStats(void)
+{
+    bus_stats.commands = 0;
+    bus_stats.bytes = 0;
+    bus_stats.caset_skipped = 0;
+    bus_stats.paset_skipped = 0;
+    bus_stats.pixels_streamed = 0;
 }
 
 void LCD_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
@@ -266,44 +432,177 @@ void LCD_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
     if (y + h > lcd_height) h = lcd_height - y;
     if (w <= 0 || h <= 0) return;
 
-    LCD_SetWindow(x, y, x + w - 1, y + h - 1);
+    int16_t span = LCD_ScrollSpan(x, w);
+    if (span < w) {
+        LCD_FillRect(x, y, span, h, color);
+        LCD_FillRect(x + span, y, w - span, h, color);
+        return;
+    }
+
+    LCD_BeginPixels(x, y, x + w - 1, y + h - 1);
+    LCD_PushColor(color, (uint32_t)w * h);
+    LCD_EndPixels();
+}
+
+#define OUT_LEFT    0x01
+#define OUT_RIGHT   0x02
+#define OUT_TOP     0x04
+#define OUT_BOTTOM  0x08
+
+static uint8_t LCD_OutCode(int16_t x, int16_t y)
+{
+    uint8_t code = 0;
+
+    if (x < 0) code |= OUT_LEFT;
+    else if (x >= lcd_width) code |= OUT_RIGHT;
+    if (y < 0) code |= OUT_TOP;
+    else if (y >= lcd_height) code |= OUT_BOTTOM;
+
+    return code;
+}
+
+// Cociente redondeado al entero más cercano
+static int32_t LCD_RoundDiv(int32_t num, int32_t den)
+{
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
 
-    LCD_CS_LOW();
-    LCD_RS_HIGH();
+    int32_t q = 2 * num + den;
+    den *= 2;
+    return (q >= 0) ? q / den : -((-q + den - 1) / den);
+}
 
-    uint8_t hi = color >> 8;
-    uint8_t lo = color & 0xFF;
+// Cohen-Sutherland: recorta el segmento a la pantalla; 0 si queda fuera.
+// Los cortes se toman en el borde del píxel (±0.5) para caer donde Bresenham entra.
+// Los códigos de los extremos vienen calculados para que la polilínea los comparta.
+static uint8_t LCD_ClipLine(int16_t* x0, int16_t* y0, uint8_t code0,
+                            int16_t* x1, int16_t* y1, uint8_t code1)
+{
+    for (uint8_t pass = 0; code0 | code1; pass++) {
+        if ((code0 & code1) || pass >= 4) return 0;
+
+        uint8_t code = code0 ? code0 : code1;
+        int32_t dx = *x1 - *x0;
+        int32_t dy = *y1 - *y0;
+        int32_t x, y;
+
+        // Medios píxeles: el borde se cruza en 2 * y0 + 2 * t * dy = borde2
+        if (code & OUT_BOTTOM) {
+            y = lcd_height - 1;
+            x = *x0 + LCD_RoundDiv(dx * (2 * lcd_height - 1 - 2 * *y0), 2 * dy);
+        } else if (code & OUT_TOP) {
+            y = 0;
+            x = *x0 + LCD_RoundDiv(dx * (-1 - 2 * *y0), 2 * dy);
+        } else if (code & OUT_RIGHT) {
+            x = lcd_width - 1;
+            y = *y0 + LCD_RoundDiv(dy * (2 * lcd_width - 1 - 2 * *x0), 2 * dx);
+        } else {
+            x = 0;
+            y = *y0 + LCD_RoundDiv(dy * (-1 - 2 * *x0), 2 * dx);
+        }
 
-    for (int32_t i = 0; i < (int32_t)w * h; i++) {
-        LCD_WriteDataBus(hi);
-        LCD_WriteDataBus(lo);
+        if (code == code0) {
+            *x0 = x;
+            *y0 = y;
+            code0 = LCD_OutCode(*x0, *y0);
+        } else {
+            *x1 = x;
+            *y1 = y;
+            code1 = LCD_OutCode(*x1, *y1);
+        }
     }
 
-    LCD_CS_HIGH();
+    return 1;
 }
 
-void LCD_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+// Bresenham por tramos: los pasos seguidos sobre el eje mayor salen en una sola ráfaga
+static void LCD_LineRuns(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color, uint8_t skip_first)
 {
     int16_t dx = abs(x1 - x0);
     int16_t dy = abs(y1 - y0);
     int16_t sx = (x0 < x1) ? 1 : -1;
     int16_t sy = (y0 < y1) ? 1 : -1;
     int16_t err = dx - dy;
+    uint8_t x_major = (dx >= dy);
 
-    while (1) {
-        LCD_DrawPixel(x0, y0, color);
+    int16_t run_x = x0;
+    int16_t run_y = y0;
 
+    while (1) {
         if (x0 == x1 && y0 == y1) break;
 
         int16_t e2 = 2 * err;
+        int16_t nx = x0;
+        int16_t ny = y0;
+
         if (e2 > -dy) {
             err -= dy;
-            x0 += sx;
+            nx += sx;
         }
         if (e2 < dx) {
             err += dx;
-            y0 += sy;
+            ny += sy;
+        }
+
+        if (skip_first) {
+            // El primer píxel ya lo pintó el segmento anterior de la polilínea
+            skip_first = 0;
+            run_x = nx;
+            run_y = ny;
+        } else if (x_major ? (ny != y0) : (nx != x0)) {
+            // Cambio en el eje menor: termina el tramo actual
+            LCD_FillRect((run_x < x0) ? run_x : x0, (run_y < y0) ? run_y : y0,
+                         abs(x0 - run_x) + 1, abs(y0 - run_y) + 1, color);
+            run_x = nx;
+            run_y = ny;
+        }
+
+        x0 = nx;
+        y0 = ny;
+    }
+
+    if (skip_first) return;
+
+    LCD_FillRect((run_x < x0) ? run_x : x0, (run_y < y0) ? run_y : y0,
+                 abs(x0 - run_x) + 1, abs(y0 - run_y) + 1, color);
+}
+
+void LCD_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+    if (!LCD_ClipLine(&x0, &y0, LCD_OutCode(x0, y0), &x1, &y1, LCD_OutCode(x1, y1))) return;
+
+    LCD_LineRuns(x0, y0, x1, y1, color, 0);
+}
+
+void LCD_DrawPolyline(const LCDPoint* points, uint16_t count, uint8_t closed, uint16_t color)
+{
+    if (count == 0) return;
+
+    if (count == 1) {
+        LCD_DrawPixel(points[0].x, points[0].y, color);
+        return;
+    }
+
+    uint16_t segments = closed ? count : count - 1;
+    uint8_t code_prev = LCD_OutCode(points[0].x, points[0].y);
+
+    for (uint16_t i = 0; i < segments; i++) {
+        const LCDPoint* p0 = &points[i];
+        const LCDPoint* p1 = &points[(i + 1 == count) ? 0 : i + 1];
+        uint8_t code_next = LCD_OutCode(p1->x, p1->y);
+
+        int16_t x0 = p0->x, y0 = p0->y;
+        int16_t x1 = p1->x, y1 = p1->y;
+
+        if (LCD_ClipLine(&x0, &y0, code_prev, &x1, &y1, code_next)) {
+            // El vértice compartido solo se pinta una vez si no se recortó
+            uint8_t skip = (i > 0 && code_prev == 0);
+            LCD_LineRuns(x0, y0, x1, y1, color, skip);
         }
+
+        code_prev = code_next;
     }
 }
 
@@ -341,32 +640,118 @@ void LCD_DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
     }
 }
 
-// NUEVA FUNCIÓN - FillCircle con clipping correcto
+// Semiancho entero de cada fila de un disco: half[i] = max x con x² + dy² <= r²,
+// dy = first + i. Punto medio incremental, sin multiplicaciones ni sqrtf.
+void LCD_CircleHalfWidths(int16_t r, int16_t first, int16_t* half, int16_t count)
+{
+    int16_t x = r;
+    int32_t d = 0;   // r² - x² - dy²
+
+    if (first + count > r + 1) count = r + 1 - first;
+
+    for (int16_t dy = 0; dy < first + count; dy++) {
+        if (dy > 0) d -= 2 * dy - 1;
+
+        while (d < 0) {
+            d += 2 * x - 1;
+            x--;
+        }
+
+        if (dy >= first) half[dy - first] = x;
+    }
+}
+
+// Filas visibles del disco y rango de |dy| que las cubre (cabe en LCD_HEIGHT entradas)
+static uint8_t LCD_CircleRows(int16_t y0, int16_t r, int16_t* y_min, int16_t* y_max, int16_t* near)
+{
+    *y_min = (y0 - r < 0) ? 0 : y0 - r;
+    *y_max = (y0 + r >= lcd_height) ? lcd_height - 1 : y0 + r;
+    if (*y_min > *y_max) return 0;
+
+    if (y0 < *y_min) *near = *y_min - y0;
+    else if (y0 > *y_max) *near = y0 - *y_max;
+    else *near = 0;
+
+    return 1;
+}
+
+static int16_t LCD_CircleFar(int16_t y0, int16_t y_min, int16_t y_max)
+{
+    int16_t top = abs(y_min - y0);
+    int16_t bottom = abs(y_max - y0);
+    return (top > bottom) ? top : bottom;
+}
+
+static int16_t half_a[LCD_HEIGHT];
+static int16_t half_b[LCD_HEIGHT];
+
 void LCD_FillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
 {
-    // Dibujar usando líneas verticales con clipping
-    for (int16_t y = -r; y <= r; y++) {
-        int16_t x_extent = (int16_t)sqrtf(r * r - y * y);
+    int16_t y_min, y_max, near;
+
+    if (r < 0) return;
+    if (!LCD_CircleRows(y0, r, &y_min, &y_max, &near)) return;
+
+    LCD_CircleHalfWidths(r, near, half_a, LCD_CircleFar(y0, y_min, y_max) - near + 1);
+
+    for (int16_t y = y_min; y <= y_max; y++) {
+        int16_t x_extent = half_a[abs(y - y0) - near];
+        LCD_DrawHLine(x0 - x_extent, y, 2 * x_extent + 1, color);
+    }
+}
+
+// Pinta lo que cubría el disco (ax, ay, ar) y no cubre el disco (bx, by, br).
+// Al mover o encoger un cuerpo solo se borra la media luna que quedó al descubierto.
+void LCD_FillDiscDifference(int16_t ax, int16_t ay, int16_t ar,
+                            int16_t bx, int16_t by, int16_t br, uint16_t color)
+{
+    int16_t y_min, y_max, a_near;
+    int16_t b_min = 1, b_max = 0, b_near = 0;
+
+    if (ar < 0) return;
+    if (!LCD_CircleRows(ay, ar, &y_min, &y_max, &a_near)) return;
+
+    LCD_CircleHalfWidths(ar, a_near, half_a, LCD_CircleFar(ay, y_min, y_max) - a_near + 1);
+
+    if (br >= 0 && LCD_CircleRows(by, br, &b_min, &b_max, &b_near)) {
+        LCD_CircleHalfWidths(br, b_near, half_b, LCD_CircleFar(by, b_min, b_max) - b_near + 1);
+    } else {
+        b_min = 1;
+        b_max = 0;
+    }
 
-        int16_t y_pos = y0 + y;
-        int16_t x_start = x0 - x_extent;
-        int16_t x_end = x0 + x_extent;
+    for (int16_t y = y_min; y <= y_max; y++) {
+        int16_t a_half = half_a[abs(y - ay) - a_near];
+        int16_t x_start = ax - a_half;
+        int16_t x_end = ax + a_half;
 
-        // Clip Y
-        if (y_pos < 0 || y_pos >= lcd_height) continue;
+        if (y < b_min || y > b_max) {
+            LCD_DrawHLine(x_start, y, x_end - x_start + 1, color);
+            continue;
+        }
 
-        // Clip X
-        if (x_start < 0) x_start = 0;
-        if (x_end >= lcd_width) x_end = lcd_width - 1;
+        int16_t b_half = half_b[abs(y - by) - b_near];
+        int16_t b_start = bx - b_half;
+        int16_t b_end = bx + b_half;
 
-        // Si después de clip no hay nada que dibujar, skip
-        if (x_start > x_end) continue;
+        // Hasta dos tramos: a la izquierda y a la derecha del disco nuevo
+        int16_t left_end = (b_start - 1 < x_end) ? b_start - 1 : x_end;
+        int16_t right_start = (b_end + 1 > x_start) ? b_end + 1 : x_start;
 
-        // Dibujar línea horizontal
-        LCD_DrawHLine(x_start, y_pos, x_end - x_start + 1, color);
+        if (left_end >= x_start) {
+            LCD_DrawHLine(x_start, y, left_end - x_start + 1, color);
+        }
+        if (right_start <= x_end) {
+            LCD_DrawHLine(right_start, y, x_end - right_start + 1, color);
+        }
     }
 }
 
+void LCD_FillAnnulus(int16_t x0, int16_t y0, int16_t r_inner, int16_t r_outer, uint16_t color)
+{
+    LCD_FillDiscDifference(x0, y0, r_outer, x0, y0, r_inner, color);
+}
+
 void LCD_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
 {
     LCD_FillRect(x, y, w, 1, color);
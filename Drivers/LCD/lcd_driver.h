@@ -1,7 +1,7 @@
 #ifndef LCD_DRIVER_H
 #define LCD_DRIVER_H
 
-#include "main.h"
+#include "lcd_device.h"
 #include <stdint.h>
 
 // Configuración del LCD
@@ -11,12 +11,23 @@
 // Comandos LCD
 #define LCD_CMD_SWRESET     0x01
 #define LCD_CMD_SLPOUT      0x11
+#define LCD_CMD_INVOFF      0x20
+#define LCD_CMD_INVON       0x21
+#define LCD_CMD_DISPOFF     0x28
 #define LCD_CMD_DISPON      0x29
 #define LCD_CMD_CASET       0x2A
 #define LCD_CMD_PASET       0x2B
 #define LCD_CMD_RAMWR       0x2C
+#define LCD_CMD_VSCRDEF     0x33
 #define LCD_CMD_MADCTL      0x36
+#define LCD_CMD_VSCRSADD    0x37
 #define LCD_CMD_COLMOD      0x3A
+#define LCD_CMD_WRDISBV     0x51
+#define LCD_CMD_WRCTRLD     0x53
+#define LCD_CMD_PGAMCTRL    0xE0
+#define LCD_CMD_NGAMCTRL    0xE1
+
+#define LCD_GAMMA_LENGTH    15
 
 // Colores RGB565
 #define COLOR_BLACK       0x0000
@@ -43,27 +54,75 @@
 #define COLOR_SPACE       0x0000
 #define COLOR_STAR        0xFFFF
 
-// Macros para control de pines
-#define LCD_CS_LOW()    HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_RESET)
-#define LCD_CS_HIGH()   HAL_GPIO_WritePin(LCD_CS_GPIO_Port, LCD_CS_Pin, GPIO_PIN_SET)
-#define LCD_RS_LOW()    HAL_GPIO_WritePin(LCD_RS_GPIO_Port, LCD_RS_Pin, GPIO_PIN_RESET)
-#define LCD_RS_HIGH()   HAL_GPIO_WritePin(LCD_RS_GPIO_Port, LCD_RS_Pin, GPIO_PIN_SET)
-#define LCD_WR_LOW()    HAL_GPIO_WritePin(LCD_WR_GPIO_Port, LCD_WR_Pin, GPIO_PIN_RESET)
-#define LCD_WR_HIGH()   HAL_GPIO_WritePin(LCD_WR_GPIO_Port, LCD_WR_Pin, GPIO_PIN_SET)
-#define LCD_RD_LOW()    HAL_GPIO_WritePin(LCD_RD_GPIO_Port, LCD_RD_Pin, GPIO_PIN_RESET)
-#define LCD_RD_HIGH()   HAL_GPIO_WritePin(LCD_RD_GPIO_Port, LCD_RD_Pin, GPIO_PIN_SET)
-#define LCD_RST_LOW()   HAL_GPIO_WritePin(LCD_RST_GPIO_Port, LCD_RST_Pin, GPIO_PIN_RESET)
-#define LCD_RST_HIGH()  HAL_GPIO_WritePin(LCD_RST_GPIO_Port, LCD_RST_Pin, GPIO_PIN_SET)
+// Contadores de tráfico en el bus desde el último reset
+typedef struct {
+    uint32_t commands;
+    uint32_t bytes;
+    uint32_t caset_skipped;
+    uint32_t paset_skipped;
+    uint32_t pixels_streamed;
+} LCDBusStats;
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+} LCDPoint;
 
 // Funciones públicas del LCD
 void LCD_Init(void);
+void LCD_DisplayOn(void);
+void LCD_DisplayOff(void);
 void LCD_Clear(uint16_t color);
+
+// Efectos del propio panel: unos pocos bytes de comando, sin reescribir píxeles.
+// Igual que el resto de comandos, con la cola del LCD vacía.
+void LCD_SetInversion(uint8_t on);
+void LCD_SetBrightness(uint8_t level);
+void LCD_SetGamma(const uint8_t* positive, const uint8_t* negative);
+
+// Curvas de fábrica de PGAMCTRL (E0) y NGAMCTRL (E1)
+extern const uint8_t lcd_gamma_positive[LCD_GAMMA_LENGTH];
+extern const uint8_t lcd_gamma_negative[LCD_GAMMA_LENGTH];
+
 void LCD_DrawPixel(int16_t x, int16_t y, uint16_t color);
 void LCD_DrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+void LCD_DrawPolyline(const LCDPoint* points, uint16_t count, uint8_t closed, uint16_t color);
 void LCD_DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
 void LCD_FillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+void LCD_FillAnnulus(int16_t x0, int16_t y0, int16_t r_inner, int16_t r_outer, uint16_t color);
+void LCD_FillDiscDifference(int16_t ax, int16_t ay, int16_t ar,
+                            int16_t bx, int16_t by, int16_t br, uint16_t color);
 void LCD_FillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
 void LCD_DrawHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
 void LCD_DrawVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+void LCD_DrawBitmap(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);
+
+// Semianchos enteros de las filas |dy| = first..first+count-1 de un disco de radio r
+void LCD_CircleHalfWidths(int16_t r, int16_t first, int16_t* half, int16_t count);
+
+// Escritura en ráfaga dentro de una ventana (coordenadas ya recortadas)
+void LCD_BeginPixels(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+void LCD_PushPixels(const uint16_t* pixels, uint32_t count);
+void LCD_PushColor(uint16_t color, uint32_t count);
+void LCD_EndPixels(void);
+
+// Ráfaga sin esperar al bus (DMA en SPI): el buffer se lee hasta que LCD_Busy devuelva 0
+void LCD_StartPixels(const uint16_t* pixels, uint32_t count);
+uint8_t LCD_Busy(void);
+
+// Destino de todas las primitivas (por defecto el bus elegido con LCD_BACKEND)
+void LCD_SetDevice(const LCDDevice* device);
+const LCDDevice* LCD_GetDevice(void);
+
+// Scroll por hardware. En horizontal el eje de scroll del panel son las columnas:
+// las primitivas reciben columnas de pantalla y las traducen a columnas de la RAM.
+void LCD_SetScrollArea(uint16_t top_fixed, uint16_t bottom_fixed);
+void LCD_SetScroll(uint16_t offset);
+uint16_t LCD_GetScroll(void);
+int16_t LCD_MapX(int16_t x);
+int16_t LCD_ScrollSpan(int16_t x, int16_t w);
+
+const LCDBusStats* LCD_GetBusStats(void);
+void LCD_ResetBusStats(void);
 
 #endif // LCD_DRIVER_H
@@ -0,0 +1,238 @@
+#include "lcd_queue.h"
+#include "lcd_driver.h"
+#include "main.h"
+
+enum {
+    LCDQ_WINDOW,
+    LCDQ_PIXELS,
+    LCDQ_COLOR,
+    LCDQ_END,
+    LCDQ_FENCE
+};
+
+typedef struct {
+    uint8_t op;
+    uint16_t color;
+    int16_t x0, y0, x1, y1;
+    const uint16_t* pixels;
+    uint32_t count;
+} LCDQueueItem;
+
+#if LCD_QUEUE_ENABLE
+
+// En el host se puede sustituir por una llamada directa a LCDQueue_Service
+#ifndef LCD_QUEUE_PEND
+#define LCD_QUEUE_PEND()  (SCB->ICSR = SCB_ICSR_PENDSVSET_Msk)
+#endif
+
+// Un productor (bucle principal) y un consumidor (PendSV): head solo lo escribe el
+// productor y tail solo el consumidor
+static LCDQueueItem queue[LCD_QUEUE_SIZE];
+static volatile uint16_t head = 0;
+static volatile uint16_t tail = 0;
+
+static volatile uint32_t fence_issued = 0;
+static volatile uint32_t fence_done = 0;
+
+void LCDQueue_Init(void)
+{
+    head = 0;
+    tail = 0;
+    fence_issued = 0;
+    fence_done = 0;
+}
+
+static LCDQueueItem* LCDQueue_Reserve(void)
+{
+    uint16_t next = (head + 1) % LCD_QUEUE_SIZE;
+
+    // Cola llena: se espera a que el consumidor libere sitio
+    while (next == tail) {
+        LCD_QUEUE_PEND();
+    }
+
+    return &queue[head];
+}
+
+static void LCDQueue_Commit(void)
+{
+    // Un solo núcleo: basta con que el compilador no adelante la publicación
+    __COMPILER_BARRIER();
+    head = (head + 1) % LCD_QUEUE_SIZE;
+}
+
+void LCDQueue_Window(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    LCDQueueItem* item = LCDQueue_Reserve();
+
+    item->op = LCDQ_WINDOW;
+    item->x0 = x0;
+    item->y0 = y0;
+    item->x1 = x1;
+    item->y1 = y1;
+    LCDQueue_Commit();
+}
+
+void LCDQueue_Pixels(const uint16_t* pixels, uint32_t count)
+{
+    LCDQueueItem* item = LCDQueue_Reserve();
+
+    item->op = LCDQ_PIXELS;
+    item->pixels = pixels;
+    item->count = count;
+    LCDQueue_Commit();
+}
+
+void LCDQueue_Color(uint16_t color, uint32_t count)
+{
+    LCDQueueItem* item = LCDQueue_Reserve();
+
+    item->op = LCDQ_COLOR;
+    item->color = color;
+    item->count = count;
+    LCDQueue_Commit();
+}
+
+void LCDQueue_End(void)
+{
+    LCDQueueItem* item = LCDQueue_Reserve();
+
+    item->op = LCDQ_END;
+    LCDQueue_Commit();
+}
+
+uint32_t LCDQueue_Fence(void)
+{
+    LCDQueueItem* item = LCDQueue_Reserve();
+    uint32_t fence = fence_issued + 1;
+
+    item->op = LCDQ_FENCE;
+    item->count = fence;
+    fence_issued = fence;
+    LCDQueue_Commit();
+
+    // Lo encolado hasta aquí empieza a enviarse en cuanto el bucle no tenga prioridad
+    LCD_QUEUE_PEND();
+    return fence;
+}
+
+uint8_t LCDQueue_FenceDone(uint32_t fence)
+{
+    return (int32_t)(fence_done - fence) >= 0;
+}
+
+void LCDQueue_WaitFence(uint32_t fence)
+{
+    while (!LCDQueue_FenceDone(fence)) {
+        LCD_QUEUE_PEND();
+    }
+}
+
+void LCDQueue_Flush(void)
+{
+    if (head == tail) return;
+
+    LCDQueue_WaitFence(LCDQueue_Fence());
+}
+
+void LCDQueue_Resume(void)
+{
+    LCD_QUEUE_PEND();
+}
+
+void LCDQueue_Service(void)
+{
+    while (tail != head) {
+        LCDQueueItem* item = &queue[tail];
+
+        // Ráfaga por DMA en curso: su interrupción de fin vuelve a llamar a LCDQueue_Resume
+        if (LCD_Busy()) return;
+
+        switch (item->op) {
+            case LCDQ_WINDOW:
+                LCD_BeginPixels(item->x0, item->y0, item->x1, item->y1);
+                break;
+            case LCDQ_PIXELS:
+                // Por tramos: la entrada sigue en la cola hasta enviar el último
+                if (item->count > LCD_DEVICE_BURST_MAX) {
+                    LCD_StartPixels(item->pixels, LCD_DEVICE_BURST_MAX);
+                    item->pixels += LCD_DEVICE_BURST_MAX;
+                    item->count -= LCD_DEVICE_BURST_MAX;
+                    continue;
+                }
+                LCD_StartPixels(item->pixels, item->count);
+                break;
+            case LCDQ_COLOR:
+                if (item->count > LCD_DEVICE_BURST_MAX) {
+                    LCD_PushColor(item->color, LCD_DEVICE_BURST_MAX);
+                    item->count -= LCD_DEVICE_BURST_MAX;
+                    continue;
+                }
+                LCD_PushColor(item->color, item->count);
+                break;
+            case LCDQ_END:
+                LCD_EndPixels();
+                break;
+            case LCDQ_FENCE:
+                fence_done = item->count;
+                break;
+        }
+
+        tail = (tail + 1) % LCD_QUEUE_SIZE;
+    }
+}
+
+#else
+
+// Sin cola: ejecución inmediata
+void LCDQueue_Init(void)
+{
+}
+
+void LCDQueue_Window(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    LCD_BeginPixels(x0, y0, x1, y1);
+}
+
+void LCDQueue_Pixels(const uint16_t* pixels, uint32_t count)
+{
+    LCD_PushPixels(pixels, count);
+}
+
+void LCDQueue_Color(uint16_t color, uint32_t count)
+{
+    LCD_PushColor(color, count);
+}
+
+void LCDQueue_End(void)
+{
+    LCD_EndPixels();
+}
+
+uint32_t LCDQueue_Fence(void)
+{
+    return 0;
+}
+
+uint8_t LCDQueue_FenceDone(uint32_t fence)
+{
+    return 1;
+}
+
+void LCDQueue_WaitFence(uint32_t fence)
+{
+}
+
+void LCDQueue_Flush(void)
+{
+}
+
+void LCDQueue_Resume(void)
+{
+}
+
+void LCDQueue_Service(void)
+{
+}
+
+#endif
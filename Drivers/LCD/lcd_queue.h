@@ -0,0 +1,41 @@
+#ifndef LCD_QUEUE_H
+#define LCD_QUEUE_H
+
+#include "lcd_device.h"
+#include <stdint.h>
+
+// Cola de escrituras al LCD vaciada desde PendSV (prioridad mínima). Con 0 cada
+// operación se ejecuta en el momento y las barreras quedan cumplidas al instante.
+// El bus paralelo escribe por CPU y no tiene nada que solapar: por defecto solo
+// se encola con SPI, donde las ráfagas van por DMA.
+#ifndef LCD_QUEUE_ENABLE
+#define LCD_QUEUE_ENABLE (LCD_BACKEND == LCD_BACKEND_SPI)
+#endif
+
+// Descriptores en el anillo (20 bytes cada uno)
+#define LCD_QUEUE_SIZE 128
+
+void LCDQueue_Init(void);
+
+// Los píxeles quedan referenciados, no copiados: el buffer no se puede reutilizar
+// hasta que se cumpla una barrera posterior a su envío
+void LCDQueue_Window(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+void LCDQueue_Pixels(const uint16_t* pixels, uint32_t count);
+void LCDQueue_Color(uint16_t color, uint32_t count);
+void LCDQueue_End(void);
+
+// Barreras: marcan un punto de la cola y permiten esperar a que se haya enviado
+uint32_t LCDQueue_Fence(void);
+uint8_t LCDQueue_FenceDone(uint32_t fence);
+void LCDQueue_WaitFence(uint32_t fence);
+
+// Espera a que la cola quede vacía (antes de dibujar directamente en el LCD)
+void LCDQueue_Flush(void);
+
+// Fin de una transferencia del bus en segundo plano (interrupción del DMA)
+void LCDQueue_Resume(void);
+
+// Consumidor: PendSV_Handler, o el modelo de la interrupción en el host
+void LCDQueue_Service(void);
+
+#endif
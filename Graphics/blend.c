@@ -0,0 +1,179 @@
+#include "blend.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "main.h"
+#endif
+
+// Cada canal de dos píxeles queda en su propia media palabra (lanes de 16 bits)
+#define LANES_R(p)  (((p) >> 11) & 0x001F001FU)
+#define LANES_G(p)  (((p) >> 5) & 0x003F003FU)
+#define LANES_B(p)  ((p) & 0x001F001FU)
+#define LANES_PACK(r, g, b)  (((r) << 11) | ((g) << 5) | (b))
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+
+// Instrucciones SIMD del Cortex-M4 (CMSIS cmsis_gcc.h)
+static inline uint32_t lanes_hadd(uint32_t a, uint32_t b)
+{
+    return __UHADD16(a, b);
+}
+
+static inline uint32_t lanes_add_sat5(uint32_t a, uint32_t b)
+{
+    return __USAT16(__UADD16(a, b), 5);
+}
+
+static inline uint32_t lanes_add_sat6(uint32_t a, uint32_t b)
+{
+    return __USAT16(__UADD16(a, b), 6);
+}
+
+// USUB16 deja GE activo en los lanes donde a >= b; SEL elige la resta o 0
+static inline uint32_t lanes_sub_floor(uint32_t a, uint32_t b)
+{
+    uint32_t diff = __USUB16(a, b);
+    return __SEL(diff, 0);
+}
+
+#else
+
+// Emulación en C, bit a bit, de la semántica de las mismas instrucciones
+static inline uint32_t lanes_hadd(uint32_t a, uint32_t b)
+{
+    // UHADD16: (a + b) >> 1 sin signo por media palabra, sin perder el acarreo
+    uint32_t lo = ((a & 0xFFFFU) + (b & 0xFFFFU)) >> 1;
+    uint32_t hi = ((a >> 16) + (b >> 16)) >> 1;
+    return (hi << 16) | lo;
+}
+
+static inline uint32_t lanes_uadd16(uint32_t a, uint32_t b)
+{
+    uint32_t lo = (a + b) & 0xFFFFU;
+    uint32_t hi = ((a >> 16) + (b >> 16)) & 0xFFFFU;
+    return (hi << 16) | lo;
+}
+
+static inline uint32_t lanes_usat16(uint32_t x, uint8_t bits)
+{
+    // USAT16: cada media palabra con signo se satura a [0, 2^bits - 1]
+    int32_t max = (1 << bits) - 1;
+    int32_t lo = (int16_t)(x & 0xFFFFU);
+    int32_t hi = (int16_t)(x >> 16);
+
+    if (lo < 0) lo = 0;
+    if (lo > max) lo = max;
+    if (hi < 0) hi = 0;
+    if (hi > max) hi = max;
+
+    return ((uint32_t)hi << 16) | (uint32_t)lo;
+}
+
+static inline uint32_t lanes_add_sat5(uint32_t a, uint32_t b)
+{
+    return lanes_usat16(lanes_uadd16(a, b), 5);
+}
+
+static inline uint32_t lanes_add_sat6(uint32_t a, uint32_t b)
+{
+    return lanes_usat16(lanes_uadd16(a, b), 6);
+}
+
+static inline uint32_t lanes_sub_floor(uint32_t a, uint32_t b)
+{
+    // USUB16 + SEL(diff, 0): GE por media palabra cuando a >= b
+    uint32_t lo = ((a & 0xFFFFU) >= (b & 0xFFFFU)) ? ((a - b) & 0xFFFFU) : 0;
+    uint32_t hi = ((a >> 16) >= (b >> 16)) ? (((a >> 16) - (b >> 16)) & 0xFFFFU) : 0;
+    return (hi << 16) | lo;
+}
+
+#endif
+
+uint16_t Blend_RGB565(uint16_t fg, uint16_t bg, uint8_t alpha)
+{
+    if (alpha >= BLEND_ALPHA_MAX) return fg;
+
+    // G pasa a la mitad alta para dejar sitio al producto de cada canal
+    uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81FU;
+    uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81FU;
+    uint32_t r = ((f * alpha + b * (BLEND_ALPHA_MAX - alpha)) >> 5) & 0x07E0F81FU;
+
+    return (uint16_t)(r | (r >> 16));
+}
+
+uint32_t Blend_RGB565x2(uint32_t fg2, uint32_t bg2, uint8_t alpha)
+{
+    if (alpha >= BLEND_ALPHA_MAX) return fg2;
+
+    uint32_t inv = BLEND_ALPHA_MAX - alpha;
+
+    // Un solo MUL escala ambos lanes: el producto máximo (63 * 32) cabe en 16 bits
+    uint32_t r = ((LANES_R(fg2) * alpha + LANES_R(bg2) * inv) >> 5) & 0x001F001FU;
+    uint32_t g = ((LANES_G(fg2) * alpha + LANES_G(bg2) * inv) >> 5) & 0x003F003FU;
+    uint32_t b = ((LANES_B(fg2) * alpha + LANES_B(bg2) * inv) >> 5) & 0x001F001FU;
+
+    return LANES_PACK(r, g, b);
+}
+
+uint32_t Blend_Average2(uint32_t a2, uint32_t b2)
+{
+    uint32_t r = lanes_hadd(LANES_R(a2), LANES_R(b2));
+    uint32_t g = lanes_hadd(LANES_G(a2), LANES_G(b2));
+    uint32_t b = lanes_hadd(LANES_B(a2), LANES_B(b2));
+
+    return LANES_PACK(r, g, b);
+}
+
+uint32_t Blend_AddSat2(uint32_t a2, uint32_t b2)
+{
+    uint32_t r = lanes_add_sat5(LANES_R(a2), LANES_R(b2));
+    uint32_t g = lanes_add_sat6(LANES_G(a2), LANES_G(b2));
+    uint32_t b = lanes_add_sat5(LANES_B(a2), LANES_B(b2));
+
+    return LANES_PACK(r, g, b);
+}
+
+uint32_t Blend_SubSat2(uint32_t a2, uint32_t b2)
+{
+    uint32_t r = lanes_sub_floor(LANES_R(a2), LANES_R(b2));
+    uint32_t g = lanes_sub_floor(LANES_G(a2), LANES_G(b2));
+    uint32_t b = lanes_sub_floor(LANES_B(a2), LANES_B(b2));
+
+    return LANES_PACK(r, g, b);
+}
+
+void Blend_Row(uint16_t* dst, const uint16_t* src, uint16_t count, uint8_t alpha)
+{
+    uint16_t i = 0;
+
+    for (; i + 1 < count; i += 2) {
+        uint32_t f = src[i] | ((uint32_t)src[i + 1] << 16);
+        uint32_t b = dst[i] | ((uint32_t)dst[i + 1] << 16);
+        uint32_t r = Blend_RGB565x2(f, b, alpha);
+
+        dst[i] = (uint16_t)r;
+        dst[i + 1] = (uint16_t)(r >> 16);
+    }
+
+    if (i < count) {
+        dst[i] = Blend_RGB565(src[i], dst[i], alpha);
+    }
+}
+
+void Blend_RowAddSat(uint16_t* dst, const uint16_t* src, uint16_t count)
+{
+    uint16_t i = 0;
+
+    for (; i + 1 < count; i += 2) {
+        uint32_t a = dst[i] | ((uint32_t)dst[i + 1] << 16);
+        uint32_t b = src[i] | ((uint32_t)src[i + 1] << 16);
+        uint32_t r = Blend_AddSat2(a, b);
+
+        dst[i] = (uint16_t)r;
+        dst[i + 1] = (uint16_t)(r >> 16);
+    }
+
+    if (i < count) {
+        uint32_t r = Blend_AddSat2(dst[i], src[i]);
+        dst[i] = (uint16_t)r;
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef BLEND_H
+#define BLEND_H
+
+#include <stdint.h>
+
+// Alpha de 0 (solo fondo) a 32 (solo frente), misma precisión que R/B en RGB565
+#define BLEND_ALPHA_MAX 32
+
+// Un píxel
+uint16_t Blend_RGB565(uint16_t fg, uint16_t bg, uint8_t alpha);
+
+// Dos píxeles empaquetados en un uint32_t (píxel 0 en la mitad baja)
+uint32_t Blend_RGB565x2(uint32_t fg2, uint32_t bg2, uint8_t alpha);
+uint32_t Blend_Average2(uint32_t a2, uint32_t b2);
+uint32_t Blend_AddSat2(uint32_t a2, uint32_t b2);
+uint32_t Blend_SubSat2(uint32_t a2, uint32_t b2);
+
+// Filas completas, procesadas de dos en dos
+void Blend_Row(uint16_t* dst, const uint16_t* src, uint16_t count, uint8_t alpha);
+void Blend_RowAddSat(uint16_t* dst, const uint16_t* src, uint16_t count);
+
+#endif
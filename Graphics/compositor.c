@@ -0,0 +1,360 @@
+#include "compositor.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include "../Drivers/LCD/lcd_queue.h"
+#include "indexed_fb.h"
+#include <stdlib.h>
+
+typedef struct {
+    CompositorLayerFn fn;
+    void* ctx;
+} CompositorLayer;
+
+#define CHUNKS_PER_ROW  (LCD_WIDTH / COMPOSITOR_CHUNK)
+
+// Con el framebuffer indexado las bandas van a RAM: no hay envío por diferencias
+// ni hashes, y la banda se reutiliza en cuanto se escribió
+#if INDEXED_FB_ENABLE
+#define COMPOSITOR_DEFAULT_OUTPUT  IndexedFB_WriteRect
+#else
+static void Compositor_SendDelta(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);
+#define COMPOSITOR_DEFAULT_OUTPUT  Compositor_SendDelta
+#endif
+
+// Con la cola del LCD una banda se compone mientras la anterior todavía se envía
+#if LCD_QUEUE_ENABLE && !INDEXED_FB_ENABLE
+#define COMPOSITOR_BANDS  2
+#else
+#define COMPOSITOR_BANDS  1
+#endif
+
+static uint16_t band[COMPOSITOR_BANDS][COMPOSITOR_BAND_PIXELS];
+static uint32_t band_fence[COMPOSITOR_BANDS];
+static uint8_t band_index = 0;
+static CompositorLayer layers[COMPOSITOR_MAX_LAYERS];
+static uint8_t layer_count = 0;
+static uint16_t background_color = 0x0000;
+static CompositorOutputFn output = COMPOSITOR_DEFAULT_OUTPUT;
+static CompositorStats stats;
+
+#if !INDEXED_FB_ENABLE
+// Hash de cada tramo de 16 píxeles tal como quedó en el panel (19.2 KB). Con 32 bits
+// una colisión que deje un tramo cambiado sin enviar es del orden de 1 en 4·10⁹.
+static uint32_t chunk_hash[LCD_HEIGHT][CHUNKS_PER_ROW];
+static uint32_t chunk_valid[LCD_HEIGHT];
+#endif
+
+static int16_t circle_half[LCD_HEIGHT];
+
+void Compositor_Init(uint16_t background)
+{
+    layer_count = 0;
+    background_color = background;
+    output = COMPOSITOR_DEFAULT_OUTPUT;
+
+    Compositor_Invalidate(0, 0, LCD_WIDTH, LCD_HEIGHT);
+    Compositor_BeginFrame();
+}
+
+void Compositor_SetOutput(CompositorOutputFn fn)
+{
+    output = fn ? fn : COMPOSITOR_DEFAULT_OUTPUT;
+}
+
+void Compositor_BeginFrame(void)
+{
+    stats.bytes_sent = 0;
+    stats.bytes_saved = 0;
+    stats.windows = 0;
+}
+
+const CompositorStats* Compositor_GetStats(void)
+{
+    return &stats;
+}
+
+void Compositor_Invalidate(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+#if INDEXED_FB_ENABLE
+    IndexedFB_MarkDirty(x, y, w, h);
+#else
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
+    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    int16_t c0 = x / COMPOSITOR_CHUNK;
+    int16_t c1 = (x + w - 1) / COMPOSITOR_CHUNK;
+    uint32_t mask = 0;
+
+    for (int16_t c = c0; c <= c1; c++) {
+        mask |= 1UL << c;
+    }
+
+    for (int16_t row = y; row < y + h; row++) {
+        chunk_valid[row] &= ~mask;
+    }
+#endif
+}
+
+#if !INDEXED_FB_ENABLE
+
+static uint32_t Compositor_HashChunk(const uint16_t* pixels)
+{
+    // FNV-1a sobre los 16 píxeles
+    uint32_t hash = 2166136261UL;
+
+    for (uint8_t i = 0; i < COMPOSITOR_CHUNK; i++) {
+        hash = (hash ^ pixels[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+// Una fila de píxeles en su propia ventana, partida donde el scroll da la vuelta
+static void Compositor_SendRun(int16_t x, int16_t y, int16_t count, const uint16_t* src)
+{
+    while (count > 0) {
+        int16_t span = LCD_ScrollSpan(x, count);
+
+        LCDQueue_Window(x, y, x + span - 1, y);
+        LCDQueue_Pixels(src, span);
+        LCDQueue_End();
+        stats.windows++;
+
+        x += span;
+        src += span;
+        count -= span;
+    }
+}
+
+// Salida por defecto: solo se envían los tramos cuyo hash cambió desde el frame anterior.
+// Las filas con un único tramo igual al de la fila anterior comparten ventana.
+static void Compositor_SendDelta(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels)
+{
+    int16_t c_first = x / COMPOSITOR_CHUNK;
+    int16_t chunks = w / COMPOSITOR_CHUNK;
+    int16_t open_x0 = -1;
+    int16_t open_x1 = -1;
+
+    for (int16_t row = 0; row < h; row++) {
+        int16_t py = y + row;
+        const uint16_t* src = pixels + (int32_t)row * w;
+        uint32_t changed = 0;
+        uint8_t runs = 0;
+        int16_t run_c0 = 0;
+        int16_t run_c1 = -1;
+
+        for (int16_t c = 0; c < chunks; c++) {
+            int16_t sc = c_first + c;
+            uint32_t hash = Compositor_HashChunk(src + c * COMPOSITOR_CHUNK);
+
+            if ((chunk_valid[py] & (1UL << sc)) && chunk_hash[py][sc] == hash) {
+                stats.bytes_saved += COMPOSITOR_CHUNK * 2;
+                continue;
+            }
+
+            chunk_hash[py][sc] = hash;
+            chunk_valid[py] |= 1UL << sc;
+            changed |= 1UL << c;
+
+            if (c == 0 || !(changed & (1UL << (c - 1)))) {
+                runs++;
+                run_c0 = c;
+            }
+            run_c1 = c;
+        }
+
+        int16_t single_x0 = x + run_c0 * COMPOSITOR_CHUNK;
+        int16_t single_w = (run_c1 + 1 - run_c0) * COMPOSITOR_CHUNK;
+
+        // Un tramo que cruza la vuelta del scroll no puede compartir ventana
+        if (runs == 1 && LCD_ScrollSpan(single_x0, single_w) == single_w) {
+            int16_t x0 = single_x0;
+            int16_t x1 = single_x0 + single_w - 1;
+
+            // El panel sigue avanzando a la fila siguiente dentro de la ventana abierta
+            if (x0 != open_x0 || x1 != open_x1) {
+                if (open_x0 >= 0) LCDQueue_End();
+                LCDQueue_Window(x0, py, x1, y + h - 1);
+                stats.windows++;
+                open_x0 = x0;
+                open_x1 = x1;
+            }
+
+            LCDQueue_Pixels(src + run_c0 * COMPOSITOR_CHUNK, x1 - x0 + 1);
+            stats.bytes_sent += (uint32_t)(x1 - x0 + 1) * 2;
+            continue;
+        }
+
+        if (open_x0 >= 0) {
+            LCDQueue_End();
+            open_x0 = -1;
+            open_x1 = -1;
+        }
+
+        // Varios tramos en la fila: una ventana por tramo
+        int16_t c = 0;
+        while (c < chunks) {
+            if (!(changed & (1UL << c))) {
+                c++;
+                continue;
+            }
+
+            int16_t c_end = c;
+            while (c_end + 1 < chunks && (changed & (1UL << (c_end + 1)))) c_end++;
+
+            int16_t x0 = x + c * COMPOSITOR_CHUNK;
+            int16_t count = (c_end - c + 1) * COMPOSITOR_CHUNK;
+
+            Compositor_SendRun(x0, py, count, src + c * COMPOSITOR_CHUNK);
+            stats.bytes_sent += (uint32_t)count * 2;
+            c = c_end + 1;
+        }
+    }
+
+    if (open_x0 >= 0) LCDQueue_End();
+}
+#endif
+
+uint8_t Compositor_AddLayer(CompositorLayerFn fn, void* ctx)
+{
+    if (layer_count >= COMPOSITOR_MAX_LAYERS) return 0;
+
+    layers[layer_count].fn = fn;
+    layers[layer_count].ctx = ctx;
+    layer_count++;
+    return 1;
+}
+
+void Compositor_RenderRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
+    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    // Alinear a tramos de 16 columnas para que los hashes correspondan al mismo sitio
+    int16_t x_end = x + w;
+    x = x & ~(COMPOSITOR_CHUNK - 1);
+    x_end = (x_end + COMPOSITOR_CHUNK - 1) & ~(COMPOSITOR_CHUNK - 1);
+    w = x_end - x;
+
+    int16_t rows = COMPOSITOR_BAND_PIXELS / w;
+    if (rows > h) rows = h;
+
+    CompositorTile tile;
+    tile.x = x;
+    tile.w = w;
+
+    for (int16_t by = y; by < y + h; by += rows) {
+        uint16_t* pixels = band[band_index];
+
+        // La banda solo se reutiliza cuando la cola terminó de enviarla
+        LCDQueue_WaitFence(band_fence[band_index]);
+
+        tile.pixels = pixels;
+        tile.y = by;
+        tile.h = (by + rows > y + h) ? (y + h - by) : rows;
+
+        int32_t count = (int32_t)tile.w * tile.h;
+        for (int32_t i = 0; i < count; i++) {
+            pixels[i] = background_color;
+        }
+
+        for (uint8_t l = 0; l < layer_count; l++) {
+            layers[l].fn(layers[l].ctx, &tile);
+        }
+
+        output(tile.x, tile.y, tile.w, tile.h, pixels);
+
+        band_fence[band_index] = LCDQueue_Fence();
+        band_index = (band_index + 1) % COMPOSITOR_BANDS;
+    }
+}
+
+void Compositor_RenderFrame(void)
+{
+    Compositor_RenderRect(0, 0, LCD_WIDTH, LCD_HEIGHT);
+}
+
+void Compositor_SetPixel(CompositorTile* tile, int16_t x, int16_t y, uint16_t color)
+{
+    x -= tile->x;
+    y -= tile->y;
+    if (x < 0 || x >= tile->w || y < 0 || y >= tile->h) return;
+
+    tile->pixels[(int32_t)y * tile->w + x] = color;
+}
+
+void Compositor_FillRect(CompositorTile* tile, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    int16_t x0 = x - tile->x;
+    int16_t y0 = y - tile->y;
+    int16_t x1 = x0 + w;
+    int16_t y1 = y0 + h;
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > tile->w) x1 = tile->w;
+    if (y1 > tile->h) y1 = tile->h;
+
+    for (int16_t row = y0; row < y1; row++) {
+        uint16_t* dst = tile->pixels + (int32_t)row * tile->w;
+        for (int16_t col = x0; col < x1; col++) {
+            dst[col] = color;
+        }
+    }
+}
+
+void Compositor_FillCircle(CompositorTile* tile, int16_t x0, int16_t y0, int16_t r, uint16_t color)
+{
+    int16_t dy_min = tile->y - y0;
+    int16_t dy_max = tile->y + tile->h - 1 - y0;
+
+    if (dy_min < -r) dy_min = -r;
+    if (dy_max > r) dy_max = r;
+    if (dy_min > dy_max) return;
+
+    // Rango de |dy| que toca la banda
+    int16_t near = (dy_min > 0) ? dy_min : ((dy_max < 0) ? -dy_max : 0);
+    int16_t far = (-dy_min > dy_max) ? -dy_min : dy_max;
+
+    LCD_CircleHalfWidths(r, near, circle_half, far - near + 1);
+
+    for (int16_t dy = dy_min; dy <= dy_max; dy++) {
+        int16_t x_extent = circle_half[((dy < 0) ? -dy : dy) - near];
+        Compositor_FillRect(tile, x0 - x_extent, y0 + dy, 2 * x_extent + 1, 1, color);
+    }
+}
+
+void Compositor_DrawLine(CompositorTile* tile, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+    // Segmentos que no tocan la región no se recorren
+    if ((x0 < tile->x && x1 < tile->x) || (x0 >= tile->x + tile->w && x1 >= tile->x + tile->w)) return;
+    if ((y0 < tile->y && y1 < tile->y) || (y0 >= tile->y + tile->h && y1 >= tile->y + tile->h)) return;
+
+    int16_t dx = abs(x1 - x0);
+    int16_t dy = abs(y1 - y0);
+    int16_t sx = (x0 < x1) ? 1 : -1;
+    int16_t sy = (y0 < y1) ? 1 : -1;
+    int16_t err = dx - dy;
+
+    while (1) {
+        Compositor_SetPixel(tile, x0, y0, color);
+
+        if (x0 == x1 && y0 == y1) break;
+
+        int16_t e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <stdint.h>
+
+// Buffer de composición: 320x16 píxeles RGB565 (10 KB, dos con la cola del LCD)
+#define COMPOSITOR_BAND_PIXELS  (320 * 16)
+#define COMPOSITOR_MAX_LAYERS   8
+
+// Tramo de fila que se compara por hash con el frame anterior
+#define COMPOSITOR_CHUNK        16
+
+// Región de pantalla que se está componiendo, fila a fila en pixels[w * h]
+typedef struct {
+    uint16_t* pixels;
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+} CompositorTile;
+
+// Estadísticas del frame actual para la salida directa al LCD
+typedef struct {
+    uint32_t bytes_sent;
+    uint32_t bytes_saved;
+    uint32_t windows;
+} CompositorStats;
+
+// Cada capa pinta su parte de la región sobre lo que dejaron las capas anteriores
+typedef void (*CompositorLayerFn)(void* ctx, CompositorTile* tile);
+
+// Destino de cada banda terminada (por defecto el envío por diferencias al LCD, o el
+// framebuffer indexado con INDEXED_FB_ENABLE)
+typedef void (*CompositorOutputFn)(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);
+
+void Compositor_Init(uint16_t background);
+uint8_t Compositor_AddLayer(CompositorLayerFn fn, void* ctx);
+void Compositor_SetOutput(CompositorOutputFn fn);
+
+void Compositor_BeginFrame(void);
+const CompositorStats* Compositor_GetStats(void);
+
+// Para regiones pintadas en el panel sin pasar por el compositor
+void Compositor_Invalidate(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// Compone la región por bandas y envía cada banda al LCD en una sola ventana
+void Compositor_RenderRect(int16_t x, int16_t y, int16_t w, int16_t h);
+void Compositor_RenderFrame(void);
+
+// Primitivas para las capas (coordenadas de pantalla, recortadas a la región)
+void Compositor_SetPixel(CompositorTile* tile, int16_t x, int16_t y, uint16_t color);
+void Compositor_FillRect(CompositorTile* tile, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+void Compositor_FillCircle(CompositorTile* tile, int16_t x0, int16_t y0, int16_t r, uint16_t color);
+void Compositor_DrawLine(CompositorTile* tile, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+#endif
@@ -0,0 +1,135 @@
+#include "dirty_rect.h"
+#include "compositor.h"
+#include "../Drivers/LCD/lcd_driver.h"
+
+static DirtyRect rects[DIRTY_MAX_RECTS];
+static uint8_t rect_count = 0;
+
+static int32_t Dirty_Area(const DirtyRect* r)
+{
+    return (int32_t)(r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1);
+}
+
+static DirtyRect Dirty_Union(const DirtyRect* a, const DirtyRect* b)
+{
+    DirtyRect u;
+    u.x0 = (a->x0 < b->x0) ? a->x0 : b->x0;
+    u.y0 = (a->y0 < b->y0) ? a->y0 : b->y0;
+    u.x1 = (a->x1 > b->x1) ? a->x1 : b->x1;
+    u.y1 = (a->y1 > b->y1) ? a->y1 : b->y1;
+    return u;
+}
+
+// Ganancia de unir a y b: positiva si una sola ventana sale más barata que dos
+static int32_t Dirty_MergeGain(const DirtyRect* a, const DirtyRect* b)
+{
+    DirtyRect u = Dirty_Union(a, b);
+    int32_t separate = Dirty_Area(a) + Dirty_Area(b) + 2 * DIRTY_WINDOW_COST;
+    int32_t merged = Dirty_Area(&u) + DIRTY_WINDOW_COST;
+    return separate - merged;
+}
+
+static void Dirty_MergePair(uint8_t i, uint8_t j)
+{
+    rects[i] = Dirty_Union(&rects[i], &rects[j]);
+    rects[j] = rects[rect_count - 1];
+    rect_count--;
+}
+
+void Dirty_Reset(void)
+{
+    rect_count = 0;
+}
+
+void Dirty_Add(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
+    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    DirtyRect r;
+    r.x0 = x;
+    r.y0 = y;
+    r.x1 = x + w - 1;
+    r.y1 = y + h - 1;
+
+    // Ya cubierta por una región existente
+    for (uint8_t i = 0; i < rect_count; i++) {
+        if (r.x0 >= rects[i].x0 && r.x1 <= rects[i].x1 &&
+            r.y0 >= rects[i].y0 && r.y1 <= rects[i].y1) {
+            return;
+        }
+    }
+
+    // Sin hueco: se fuerza la unión más barata
+    if (rect_count == DIRTY_MAX_RECTS) {
+        uint8_t best_i = 0;
+        uint8_t best_j = 1;
+        int32_t best_gain = Dirty_MergeGain(&rects[0], &rects[1]);
+
+        for (uint8_t i = 0; i < rect_count; i++) {
+            for (uint8_t j = i + 1; j < rect_count; j++) {
+                int32_t gain = Dirty_MergeGain(&rects[i], &rects[j]);
+                if (gain > best_gain) {
+                    best_gain = gain;
+                    best_i = i;
+                    best_j = j;
+                }
+            }
+        }
+
+        Dirty_MergePair(best_i, best_j);
+    }
+
+    rects[rect_count++] = r;
+}
+
+void Dirty_AddAll(void)
+{
+    rect_count = 0;
+    Dirty_Add(0, 0, LCD_WIDTH, LCD_HEIGHT);
+}
+
+void Dirty_Merge(void)
+{
+    uint8_t merged = 1;
+
+    while (merged) {
+        merged = 0;
+
+        for (uint8_t i = 0; i < rect_count && !merged; i++) {
+            for (uint8_t j = i + 1; j < rect_count; j++) {
+                if (Dirty_MergeGain(&rects[i], &rects[j]) >= 0) {
+                    Dirty_MergePair(i, j);
+                    merged = 1;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+uint8_t Dirty_GetCount(void)
+{
+    return rect_count;
+}
+
+const DirtyRect* Dirty_GetRect(uint8_t index)
+{
+    return &rects[index];
+}
+
+void Dirty_Compose(void)
+{
+    Dirty_Merge();
+
+    for (uint8_t i = 0; i < rect_count; i++) {
+        Compositor_RenderRect(rects[i].x0, rects[i].y0,
+                              rects[i].x1 - rects[i].x0 + 1,
+                              rects[i].y1 - rects[i].y0 + 1);
+    }
+
+    rect_count = 0;
+}
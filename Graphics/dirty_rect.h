@@ -0,0 +1,32 @@
+#ifndef DIRTY_RECT_H
+#define DIRTY_RECT_H
+
+#include <stdint.h>
+
+#define DIRTY_MAX_RECTS    16
+
+// Coste fijo de una región (ventana CASET/PASET/RAMWR y paso por las capas),
+// expresado en píxeles equivalentes para compararlo con los píxeles extra de una unión
+#define DIRTY_WINDOW_COST  64
+
+// Coordenadas inclusivas en pantalla
+typedef struct {
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+} DirtyRect;
+
+void Dirty_Reset(void);
+void Dirty_Add(int16_t x, int16_t y, int16_t w, int16_t h);
+void Dirty_AddAll(void);
+
+// Une las regiones mientras abrir una ventana cueste más que los píxeles extra
+void Dirty_Merge(void);
+uint8_t Dirty_GetCount(void);
+const DirtyRect* Dirty_GetRect(uint8_t index);
+
+// Recompone y envía el conjunto unido y deja el gestor vacío para el siguiente frame
+void Dirty_Compose(void);
+
+#endif
@@ -0,0 +1,138 @@
+#include "effects.h"
+#include "../Drivers/LCD/lcd_driver.h"
+
+static uint8_t brightness = 0xFF;
+static uint8_t fade_from = 0xFF;
+static uint8_t fade_to = 0xFF;
+static uint16_t fade_ms = 0;
+static uint32_t fade_start = 0;
+
+// Peticiones pendientes de aplicar en la siguiente actualización
+static uint8_t fade_pending = 0;
+static uint8_t fading = 0;
+static uint16_t flash_ms = 0;
+static uint8_t flashing = 0;
+static uint32_t flash_end = 0;
+
+// Campos de cada parámetro de PGAMCTRL/NGAMCTRL; el octavo lleva dos de 4 bits (0)
+static const uint8_t gamma_fields[LCD_GAMMA_LENGTH] = {
+    0x0F, 0x3F, 0x3F, 0x0F, 0x1F, 0x0F, 0x7F, 0x00, 0x7F, 0x0F, 0x1F, 0x0F, 0x3F, 0x3F, 0x0F
+};
+
+static uint8_t Effects_ScaleField(uint8_t value, uint8_t level)
+{
+    return (uint8_t)(((uint16_t)value * level + 127) / 255);
+}
+
+// Curva de fábrica con cada campo escalado por level / 255: 255 la deja igual
+static void Effects_ScaleGamma(const uint8_t* curve, uint8_t level, uint8_t* out)
+{
+    for (uint8_t i = 0; i < LCD_GAMMA_LENGTH; i++) {
+        uint8_t mask = gamma_fields[i];
+
+        if (mask) {
+            out[i] = Effects_ScaleField(curve[i] & mask, level);
+        } else {
+            out[i] = (Effects_ScaleField(curve[i] >> 4, level) << 4) | Effects_ScaleField(curve[i] & 0x0F, level);
+        }
+    }
+}
+
+// Dos comandos de 15 parámetros por nivel
+static void Effects_SetLevel(uint8_t level)
+{
+    uint8_t positive[LCD_GAMMA_LENGTH];
+    uint8_t negative[LCD_GAMMA_LENGTH];
+
+    Effects_ScaleGamma(lcd_gamma_positive, level, positive);
+    Effects_ScaleGamma(lcd_gamma_negative, level, negative);
+    LCD_SetGamma(positive, negative);
+
+#if EFFECTS_LEDPWM_ENABLE
+    LCD_SetBrightness(level);
+#endif
+}
+
+void Effects_Init(uint8_t level)
+{
+    brightness = level;
+    fade_from = level;
+    fade_to = level;
+    fade_pending = 0;
+    fading = 0;
+    flash_ms = 0;
+    flashing = 0;
+
+    LCD_SetInversion(0);
+    Effects_SetLevel(level);
+}
+
+void Effects_Dim(uint8_t level, uint16_t duration_ms)
+{
+    fade_to = level;
+    fade_ms = duration_ms;
+    fade_pending = 1;
+}
+
+void Effects_FadeIn(uint16_t duration_ms)
+{
+    Effects_Dim(0xFF, duration_ms);
+}
+
+void Effects_FadeOut(uint16_t duration_ms)
+{
+    Effects_Dim(0x00, duration_ms);
+}
+
+void Effects_Flash(uint16_t duration_ms)
+{
+    flash_ms = duration_ms;
+}
+
+// Rampa cuadrática: el ojo percibe el brillo de forma aproximadamente logarítmica
+static uint8_t Effects_FadeLevel(uint32_t elapsed)
+{
+    if (elapsed >= fade_ms) return fade_to;
+
+    uint32_t t = (elapsed << 8) / fade_ms;
+    uint32_t eased = (fade_to > fade_from) ? (t * t) >> 8 : 256 - (((256 - t) * (256 - t)) >> 8);
+
+    return (uint8_t)(fade_from + (((int32_t)fade_to - fade_from) * (int32_t)eased) / 256);
+}
+
+void Effects_Update(uint32_t now)
+{
+    if (fade_pending) {
+        fade_pending = 0;
+        fade_from = brightness;
+        fade_start = now;
+        fading = (fade_to != brightness);
+    }
+
+    if (fading) {
+        uint8_t level = Effects_FadeLevel(now - fade_start);
+
+        // Las curvas solo se reenvían cuando el nivel cambia
+        if (level != brightness) {
+            Effects_SetLevel(level);
+            brightness = level;
+        }
+
+        if (level == fade_to) fading = 0;
+    }
+
+    if (flash_ms) {
+        if (!flashing) LCD_SetInversion(1);
+        flashing = 1;
+        flash_end = now + flash_ms;
+        flash_ms = 0;
+    } else if (flashing && (int32_t)(now - flash_end) >= 0) {
+        LCD_SetInversion(0);
+        flashing = 0;
+    }
+}
+
+uint8_t Effects_Busy(void)
+{
+    return fading || flashing || fade_pending || flash_ms;
+}
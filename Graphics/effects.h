@@ -0,0 +1,30 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include <stdint.h>
+
+// Fundidos, atenuación y destellos con comandos del panel (curvas de gamma e
+// inversión) en lugar de repintar píxeles. Las peticiones solo se anotan: los
+// comandos salen en Effects_Update, que se llama con la cola del LCD vacía.
+
+// En este shield la retroiluminación va fija a la alimentación y WRDISBV no hace
+// nada: el nivel se aplica escalando las curvas de gamma. Con la retroiluminación
+// en la salida LEDPWM del controlador se envía además el brillo.
+#ifndef EFFECTS_LEDPWM_ENABLE
+#define EFFECTS_LEDPWM_ENABLE 0
+#endif
+
+// Brillo al arrancar: 0 para que el primer frame aparezca con Effects_FadeIn
+void Effects_Init(uint8_t level);
+
+void Effects_FadeIn(uint16_t duration_ms);
+void Effects_FadeOut(uint16_t duration_ms);
+void Effects_Dim(uint8_t level, uint16_t duration_ms);
+
+// Pantalla invertida durante duration_ms (respuesta a una pulsación)
+void Effects_Flash(uint16_t duration_ms);
+
+void Effects_Update(uint32_t now);
+uint8_t Effects_Busy(void);
+
+#endif
@@ -0,0 +1,173 @@
+#include "indexed_fb.h"
+
+#if INDEXED_FB_ENABLE
+
+#include "../Drivers/LCD/lcd_driver.h"
+#include <string.h>
+
+static uint8_t framebuffer[INDEXED_FB_HEIGHT][INDEXED_FB_WIDTH];
+static uint16_t palette[INDEXED_FB_COLORS];
+static uint16_t palette_count = 0;
+
+// Tabla inversa RGB444 -> índice de paleta (4 KB)
+static uint8_t inverse_lut[4096];
+
+// Columnas sucias por fila; x0 > x1 indica fila limpia
+static int16_t dirty_x0[INDEXED_FB_HEIGHT];
+static int16_t dirty_x1[INDEXED_FB_HEIGHT];
+
+static uint16_t row_buffer[INDEXED_FB_WIDTH];
+
+static inline uint16_t IndexedFB_Key(uint16_t color)
+{
+    return ((color >> 12) << 8) | (((color >> 7) & 0x0F) << 4) | ((color >> 1) & 0x0F);
+}
+
+static void IndexedFB_BuildInverseLUT(void)
+{
+    for (uint16_t key = 0; key < 4096; key++) {
+        // Centro de la celda RGB444 en la escala de RGB565 (R y B a 6 bits)
+        int16_t r = ((key >> 8) << 2) | 2;
+        int16_t g = (((key >> 4) & 0x0F) << 2) | 2;
+        int16_t b = ((key & 0x0F) << 2) | 2;
+
+        uint32_t best_dist = 0xFFFFFFFF;
+        uint8_t best = 0;
+
+        for (uint16_t i = 0; i < palette_count; i++) {
+            int16_t dr = r - ((palette[i] >> 11) << 1);
+            int16_t dg = g - ((palette[i] >> 5) & 0x3F);
+            int16_t db = b - ((palette[i] & 0x1F) << 1);
+            uint32_t dist = dr * dr + dg * dg + db * db;
+
+            if (dist < best_dist) {
+                best_dist = dist;
+                best = (uint8_t)i;
+            }
+        }
+
+        inverse_lut[key] = best;
+    }
+
+    // Los colores exactos de la paleta tienen prioridad; los primeros (fijos) ganan
+    for (int16_t i = palette_count - 1; i >= 0; i--) {
+        inverse_lut[IndexedFB_Key(palette[i])] = (uint8_t)i;
+    }
+}
+
+void IndexedFB_Init(void)
+{
+    memset(framebuffer, 0, sizeof(framebuffer));
+    palette_count = 1;
+    palette[0] = 0x0000;
+    IndexedFB_BuildInverseLUT();
+    IndexedFB_MarkAllDirty();
+}
+
+void IndexedFB_SetPalette(const uint16_t* colors, uint16_t count)
+{
+    if (count > INDEXED_FB_COLORS) count = INDEXED_FB_COLORS;
+    if (count == 0) return;
+
+    if (count == palette_count && memcmp(colors, palette, count * sizeof(uint16_t)) == 0) {
+        return;
+    }
+
+    memcpy(palette, colors, count * sizeof(uint16_t));
+    palette_count = count;
+    IndexedFB_BuildInverseLUT();
+
+    // Los índices guardados apuntan a colores nuevos: todo debe reenviarse
+    IndexedFB_MarkAllDirty();
+}
+
+uint8_t IndexedFB_Quantize(uint16_t color)
+{
+    return inverse_lut[IndexedFB_Key(color)];
+}
+
+void IndexedFB_WriteRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels)
+{
+    for (int16_t row = 0; row < h; row++) {
+        int16_t py = y + row;
+        if (py < 0 || py >= INDEXED_FB_HEIGHT) continue;
+
+        const uint16_t* src = pixels + (int32_t)row * w;
+        uint8_t* dst = framebuffer[py];
+
+        for (int16_t col = 0; col < w; col++) {
+            int16_t px = x + col;
+            if (px < 0 || px >= INDEXED_FB_WIDTH) continue;
+
+            uint8_t index = inverse_lut[IndexedFB_Key(src[col])];
+            if (dst[px] == index) continue;
+
+            dst[px] = index;
+            if (px < dirty_x0[py]) dirty_x0[py] = px;
+            if (px > dirty_x1[py]) dirty_x1[py] = px;
+        }
+    }
+}
+
+void IndexedFB_MarkAllDirty(void)
+{
+    IndexedFB_MarkDirty(0, 0, INDEXED_FB_WIDTH, INDEXED_FB_HEIGHT);
+}
+
+void IndexedFB_MarkDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > INDEXED_FB_WIDTH) w = INDEXED_FB_WIDTH - x;
+    if (y + h > INDEXED_FB_HEIGHT) h = INDEXED_FB_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    for (int16_t row = y; row < y + h; row++) {
+        if (x < dirty_x0[row]) dirty_x0[row] = x;
+        if (x + w - 1 > dirty_x1[row]) dirty_x1[row] = x + w - 1;
+    }
+}
+
+void IndexedFB_Flush(void)
+{
+    int16_t y = 0;
+
+    while (y < INDEXED_FB_HEIGHT) {
+        if (dirty_x0[y] > dirty_x1[y]) {
+            y++;
+            continue;
+        }
+
+        // Filas sucias consecutivas comparten una sola ventana
+        int16_t y_end = y;
+        int16_t x0 = dirty_x0[y];
+        int16_t x1 = dirty_x1[y];
+
+        while (y_end + 1 < INDEXED_FB_HEIGHT && dirty_x0[y_end + 1] <= dirty_x1[y_end + 1]) {
+            y_end++;
+            if (dirty_x0[y_end] < x0) x0 = dirty_x0[y_end];
+            if (dirty_x1[y_end] > x1) x1 = dirty_x1[y_end];
+        }
+
+        int16_t w = x1 - x0 + 1;
+
+        LCD_BeginPixels(x0, y, x1, y_end);
+
+        for (int16_t row = y; row <= y_end; row++) {
+            const uint8_t* src = &framebuffer[row][x0];
+            for (int16_t i = 0; i < w; i++) {
+                row_buffer[i] = palette[src[i]];
+            }
+            LCD_PushPixels(row_buffer, w);
+
+            dirty_x0[row] = INDEXED_FB_WIDTH;
+            dirty_x1[row] = -1;
+        }
+
+        LCD_EndPixels();
+
+        y = y_end + 1;
+    }
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef INDEXED_FB_H
+#define INDEXED_FB_H
+
+#include <stdint.h>
+
+// Framebuffer de 8 bits por píxel (75 KB), opcional por tamaño de RAM
+#ifndef INDEXED_FB_ENABLE
+#define INDEXED_FB_ENABLE 0
+#endif
+
+#define INDEXED_FB_WIDTH   320
+#define INDEXED_FB_HEIGHT  240
+#define INDEXED_FB_COLORS  256
+
+void IndexedFB_Init(void);
+
+// Solo reconstruye la tabla inversa si la paleta cambió respecto al frame anterior
+void IndexedFB_SetPalette(const uint16_t* colors, uint16_t count);
+uint8_t IndexedFB_Quantize(uint16_t color);
+
+// Salida del compositor: cuantiza y marca sucias solo las filas que cambian
+void IndexedFB_WriteRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);
+void IndexedFB_MarkAllDirty(void);
+
+// Para regiones del panel que dejaron de coincidir con el framebuffer
+void IndexedFB_MarkDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// Envía las filas sucias expandiendo los índices a RGB565 durante el envío
+void IndexedFB_Flush(void);
+
+#endif
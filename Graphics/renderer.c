@@ -4,13 +4,33 @@
 
 static Star stars[100];
 static uint8_t stars_initialized = 0;
+static uint8_t star_count = 0;
+
+// Desplazamiento del campo de estrellas, igual al scroll por hardware del panel
+static uint16_t star_drift = 0;
 
 void Renderer_Init(void)
 {
     stars_initialized = 0;
+    star_count = 0;
+    star_drift = 0;
+}
+
+void Renderer_SetStarDrift(uint16_t drift)
+{
+    star_drift = drift % LCD_WIDTH;
 }
 
-void Renderer_DrawStars(uint32_t seed, uint8_t count)
+// Columna de pantalla de la estrella: da la vuelta igual que la RAM del panel
+static inline int16_t Renderer_StarX(int16_t x)
+{
+    x -= star_drift;
+    if (x < 0) x += LCD_WIDTH;
+    if (x >= LCD_WIDTH) x -= LCD_WIDTH;
+    return x;
+}
+
+void Renderer_SetupStars(uint32_t seed, uint8_t count)
 {
     if (count > 100) count = 100;
 
@@ -26,15 +46,31 @@ void Renderer_DrawStars(uint32_t seed, uint8_t count)
         stars_initialized = 1;
     }
 
-    for (uint8_t i = 0; i < count; i++) {
-        uint8_t b = stars[i].brightness;
-        uint16_t star_color = ((b >> 3) << 11) | ((b >> 2) << 5) | (b >> 3);
+    star_count = count;
+}
+
+static uint16_t Renderer_StarColor(const Star* star)
+{
+    uint8_t b = star->brightness;
+    return ((b >> 3) << 11) | ((b >> 2) << 5) | (b >> 3);
+}
+
+void Renderer_StarsLayer(void* ctx, CompositorTile* tile)
+{
+    for (uint8_t i = 0; i < star_count; i++) {
+        int16_t x = Renderer_StarX(stars[i].x);
+        int16_t y = stars[i].y;
+
+        // Las estrellas dobles ocupan una fila más
+        if (y + 1 < tile->y || y >= tile->y + tile->h) continue;
+
+        uint16_t star_color = Renderer_StarColor(&stars[i]);
 
-        LCD_DrawPixel(stars[i].x, stars[i].y, star_color);
+        Compositor_SetPixel(tile, x, y, star_color);
 
         if (i % 5 == 0) {
-            LCD_DrawPixel(stars[i].x + 1, stars[i].y, star_color);
-            LCD_DrawPixel(stars[i].x, stars[i].y + 1, star_color);
+            Compositor_SetPixel(tile, Renderer_StarX(stars[i].x + 1), y, star_color);
+            Compositor_SetPixel(tile, x, y + 1, star_color);
         }
     }
 }
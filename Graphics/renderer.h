@@ -2,6 +2,7 @@
 #define RENDERER_H
 
 #include "../SolarSystem/camera.h"
+#include "compositor.h"
 #include <stdint.h>
 
 typedef struct {
@@ -11,6 +12,12 @@ typedef struct {
 } Star;
 
 void Renderer_Init(void);
-void Renderer_DrawStars(uint32_t seed, uint8_t count);
+void Renderer_SetupStars(uint32_t seed, uint8_t count);
+
+// Las estrellas se dibujan desplazadas drift columnas a la izquierda, con vuelta
+void Renderer_SetStarDrift(uint16_t drift);
+
+// Capa de fondo para el compositor
+void Renderer_StarsLayer(void* ctx, CompositorTile* tile);
 
 #endif
@@ -0,0 +1,151 @@
+#include "../SolarSystem/nbody.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+// Modo N cuerpos en el PC: tiempo por paso con el árbol, error de la aceleración
+// frente a la suma directa y deriva de la energía. Disco de cuerpos iguales en
+// órbita alrededor del centro, G = 1 y masa total 1.
+
+#define MAX_COUNT  100000
+#define DT         0.01f
+
+static float pos_x[MAX_COUNT], pos_y[MAX_COUNT], pos_z[MAX_COUNT];
+static float vel_x[MAX_COUNT], vel_y[MAX_COUNT], vel_z[MAX_COUNT];
+static float mass[MAX_COUNT];
+
+static double Now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static float Random(void)
+{
+    return rand() / (float)RAND_MAX;
+}
+
+// Densidad uniforme en el disco: la masa dentro de r crece con r², y la velocidad
+// circular sale de ella
+static void Setup(NBodySet* set, uint32_t count)
+{
+    srand(44);
+
+    for (uint32_t i = 0; i < count; i++) {
+        float r = 10.0f * sqrtf(Random()) + 0.1f;
+        float a = Random() * 6.2831853f;
+        float v = sqrtf(r * r / 100.0f / r);
+
+        pos_x[i] = r * cosf(a);
+        pos_y[i] = (Random() - 0.5f) * 0.2f;
+        pos_z[i] = r * sinf(a);
+        vel_x[i] = -v * sinf(a);
+        vel_y[i] = 0.0f;
+        vel_z[i] = v * cosf(a);
+        mass[i] = 1.0f / count;
+    }
+
+    set->count = count;
+}
+
+// Exacta, O(N²): con 100k cuerpos tarda unos segundos
+static double Energy(const NBodySet* set)
+{
+    double eps2 = (double)set->softening * set->softening;
+    double kinetic = 0.0;
+    double potential = 0.0;
+
+    for (uint32_t i = 0; i < set->count; i++) {
+        double v2 = (double)vel_x[i] * vel_x[i] + (double)vel_y[i] * vel_y[i] + (double)vel_z[i] * vel_z[i];
+        kinetic += 0.5 * mass[i] * v2;
+
+        for (uint32_t j = i + 1; j < set->count; j++) {
+            double dx = pos_x[i] - pos_x[j];
+            double dy = pos_y[i] - pos_y[j];
+            double dz = pos_z[i] - pos_z[j];
+            potential -= set->gravity * mass[i] * mass[j] / sqrt(dx * dx + dy * dy + dz * dz + eps2);
+        }
+    }
+
+    return kinetic + potential;
+}
+
+// Error relativo medio de la aceleración del árbol en una muestra de cuerpos.
+// Desde el reposo un paso deja a·dt en la velocidad.
+static double TreeError(NBodySet* set, uint32_t count, uint32_t samples)
+{
+    static float tree_x[MAX_COUNT], tree_y[MAX_COUNT], tree_z[MAX_COUNT];
+    double eps2 = (double)set->softening * set->softening;
+    double sum = 0.0;
+
+    Setup(set, count);
+    for (uint32_t i = 0; i < count; i++) {
+        vel_x[i] = vel_y[i] = vel_z[i] = 0.0f;
+    }
+
+    NBody_Step(set, DT);
+    for (uint32_t i = 0; i < count; i++) {
+        tree_x[i] = vel_x[i] / DT;
+        tree_y[i] = vel_y[i] / DT;
+        tree_z[i] = vel_z[i] / DT;
+    }
+
+    // Mismas posiciones que vio el paso: media deriva sin velocidad no las mueve
+    Setup(set, count);
+
+    for (uint32_t s = 0; s < samples; s++) {
+        uint32_t i = s * (count / samples);
+        double ax = 0.0, ay = 0.0, az = 0.0;
+
+        for (uint32_t j = 0; j < count; j++) {
+            if (j == i) continue;
+
+            double dx = pos_x[j] - pos_x[i];
+            double dy = pos_y[j] - pos_y[i];
+            double dz = pos_z[j] - pos_z[i];
+            double r = sqrt(dx * dx + dy * dy + dz * dz + eps2);
+            double f = set->gravity * mass[j] / (r * r * r);
+
+            ax += f * dx;
+            ay += f * dy;
+            az += f * dz;
+        }
+
+        double ex = tree_x[i] - ax, ey = tree_y[i] - ay, ez = tree_z[i] - az;
+        sum += sqrt(ex * ex + ey * ey + ez * ez) / sqrt(ax * ax + ay * ay + az * az);
+    }
+
+    return sum / samples;
+}
+
+static void Run(uint32_t count, uint32_t steps)
+{
+    NBodySet set = { pos_x, pos_y, pos_z, vel_x, vel_y, vel_z, mass, 0, 1.0f, 0.05f, 0.5f };
+
+    double error = TreeError(&set, count, 200);
+
+    Setup(&set, count);
+    double e0 = Energy(&set);
+
+    double t0 = Now();
+    for (uint32_t s = 0; s < steps; s++) {
+        NBody_Step(&set, DT);
+    }
+    double ms = (Now() - t0) * 1e3 / steps;
+
+    double e1 = Energy(&set);
+
+    printf("N=%6u  árbol=%u  %8.2f ms/paso  error de a=%.1e  dE/E=%+.1e en %u pasos\n",
+           count, NBody_UsedTree(), ms, error, (e1 - e0) / fabs(e0), steps);
+}
+
+int main(void)
+{
+    Run(1000, 50);
+    Run(10000, 20);
+    Run(100000, 5);
+    return 0;
+}
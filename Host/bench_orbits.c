@@ -0,0 +1,216 @@
+#include "../SolarSystem/solar_system.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+// Actualización de órbitas en el PC: error de sincos_batch frente a sin/cos en
+// doble precisión, y tiempo por cuerpo de SolarSystem_Update frente al camino de
+// un cosf/sinf por llamada. Un sistema tiene como mucho MAX_BODIES cuerpos, así
+// que 1k y 100k cuerpos son muchos sistemas de 15 actualizados seguidos.
+
+#define CHUNK      50000     // sincos_batch cuenta con uint16_t
+#define MAX_ERROR  2e-7      // Algo más de medio ulp en 1.0f
+
+static float angles[CHUNK], sines[CHUNK], cosines[CHUNK];
+
+static double Now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static float Random(void)
+{
+    return rand() / (float)RAND_MAX;
+}
+
+// Ángulos en [-4π, 4π]: más de lo que acumula una órbita entre dos vueltas
+static double SinCosError(void)
+{
+    double worst = 0.0;
+
+    srand(42);
+    for (uint32_t pass = 0; pass < 20; pass++) {
+        for (uint32_t i = 0; i < CHUNK; i++) {
+            angles[i] = (Random() - 0.5f) * 8.0f * 3.14159265f;
+        }
+        sincos_batch(angles, sines, cosines, CHUNK);
+
+        for (uint32_t i = 0; i < CHUNK; i++) {
+            double es = fabs(sines[i] - sin(angles[i]));
+            double ec = fabs(cosines[i] - cos(angles[i]));
+            if (es > worst) worst = es;
+            if (ec > worst) worst = ec;
+        }
+    }
+    return worst;
+}
+
+static void BenchSinCos(uint32_t count, uint32_t repeats)
+{
+    volatile float sink = 0.0f;
+    uint32_t n = (count < CHUNK) ? count : CHUNK;
+
+    for (uint32_t i = 0; i < n; i++) {
+        angles[i] = Random() * 6.2831853f;
+    }
+
+    double t0 = Now();
+    for (uint32_t r = 0; r < repeats; r++) {
+        for (uint32_t done = 0; done < count; done += n) {
+            sincos_batch(angles, sines, cosines, n);
+            sink += sines[r % n];
+        }
+    }
+    double batch = (Now() - t0) * 1e9 / ((double)repeats * count);
+
+    t0 = Now();
+    for (uint32_t r = 0; r < repeats; r++) {
+        for (uint32_t done = 0; done < count; done += n) {
+            for (uint32_t i = 0; i < n; i++) {
+                sines[i] = sinf(angles[i]);
+                cosines[i] = cosf(angles[i]);
+            }
+            sink += sines[r % n];
+        }
+    }
+    double libm = (Now() - t0) * 1e9 / ((double)repeats * count);
+
+    printf("sincos   N=%6u  %6.2f ns/ángulo  (sinf + cosf: %6.2f)\n", count, batch, libm);
+}
+
+// Sol, seis planetas y ocho lunas repartidas entre ellos
+static void BuildSystem(SolarSystem* sys)
+{
+    CelestialBody body;
+
+    SolarSystem_Init(sys);
+    sys->time_scale = 1.0f;
+
+    CelestialBody_Init(&body, "Sun", BODY_TYPE_SUN);
+    SolarSystem_AddBody(sys, &body, BODY_NONE);
+
+    for (uint8_t p = 0; p < 6; p++) {
+        CelestialBody_Init(&body, "Planet", BODY_TYPE_PLANET);
+        CelestialBody_SetOrbitalParams(&body, 40.0f + 25.0f * p, 0.2f + Random(), 0.3f * Random());
+        SolarSystem_AddBody(sys, &body, 0);
+    }
+
+    for (uint8_t m = 0; m < MAX_BODIES - 7; m++) {
+        CelestialBody_Init(&body, "Moon", BODY_TYPE_MOON);
+        CelestialBody_SetOrbitalParams(&body, 5.0f + 3.0f * Random(), 1.0f + 2.0f * Random(), 0.5f * Random());
+        SolarSystem_AddBody(sys, &body, 1 + m % 6);
+    }
+}
+
+// Lo que hacía cada cuerpo antes del lote: tres llamadas a libm por cuerpo
+static void ReferenceUpdate(SolarSystem* sys, float dt, float* x, float* y, float* z)
+{
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        float angle = sys->orbit_angle[h] + sys->orbit_speed[h] * dt;
+        float r = sys->orbit_radius[h];
+        BodyHandle p = sys->parent[h];
+
+        x[h] = r * cosf(angle);
+        z[h] = r * sinf(angle);
+        y[h] = r * sinf(sys->orbit_tilt[h]) * sinf(angle);
+
+        if (p != BODY_NONE) {
+            x[h] += x[p];
+            y[h] += y[p];
+            z[h] += z[p];
+        }
+    }
+}
+
+// Posición exacta de cada cuerpo para sus ángulos actuales, contra la del sistema
+static double PositionError(const SolarSystem* sys)
+{
+    double x[MAX_BODIES], y[MAX_BODIES], z[MAX_BODIES];
+    double worst = 0.0;
+
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        double r = sys->orbit_radius[h];
+        BodyHandle p = sys->parent[h];
+
+        x[h] = r * cos(sys->orbit_angle[h]);
+        z[h] = r * sin(sys->orbit_angle[h]);
+        y[h] = r * sin(sys->orbit_tilt[h]) * sin(sys->orbit_angle[h]);
+
+        if (p != BODY_NONE) {
+            x[h] += x[p];
+            y[h] += y[p];
+            z[h] += z[p];
+        }
+
+        // Relativo a la distancia al origen: la luna hereda el redondeo de su planeta
+        double e = fabs(x[h] - sys->pos_x[h]) + fabs(y[h] - sys->pos_y[h]) + fabs(z[h] - sys->pos_z[h]);
+        double d = sqrt(x[h] * x[h] + y[h] * y[h] + z[h] * z[h]);
+        if (d > 0.0 && e / d > worst) worst = e / d;
+    }
+    return worst;
+}
+
+static double BenchUpdate(uint32_t count, uint32_t frames)
+{
+    uint32_t systems = (count + MAX_BODIES - 1) / MAX_BODIES;
+    SolarSystem* sys = malloc(systems * sizeof(SolarSystem));
+    float x[MAX_BODIES], y[MAX_BODIES], z[MAX_BODIES];
+    volatile float sink = 0.0f;
+    double worst = 0.0;
+
+    srand(7);
+    for (uint32_t s = 0; s < systems; s++) {
+        BuildSystem(&sys[s]);
+    }
+
+    double t0 = Now();
+    for (uint32_t f = 0; f < frames; f++) {
+        for (uint32_t s = 0; s < systems; s++) {
+            SolarSystem_Update(&sys[s], 0.033f);
+        }
+    }
+    double batch = (Now() - t0) * 1e9 / ((double)frames * systems * MAX_BODIES);
+
+    t0 = Now();
+    for (uint32_t f = 0; f < frames; f++) {
+        for (uint32_t s = 0; s < systems; s++) {
+            ReferenceUpdate(&sys[s], 0.033f, x, y, z);
+            sink += x[f % MAX_BODIES];
+        }
+    }
+    double libm = (Now() - t0) * 1e9 / ((double)frames * systems * MAX_BODIES);
+
+    for (uint32_t s = 0; s < systems; s++) {
+        double e = PositionError(&sys[s]);
+        if (e > worst) worst = e;
+    }
+
+    printf("órbitas  N=%6u  %6.2f ns/cuerpo  (libm por cuerpo: %6.2f)  error relativo=%.1e\n",
+           systems * MAX_BODIES, batch, libm, worst);
+
+    free(sys);
+    return worst;
+}
+
+int main(void)
+{
+    int failures = 0;
+    double error = SinCosError();
+
+    printf("sincos_batch: error máximo %.1e en [-4π, 4π]\n", error);
+    if (error > MAX_ERROR) failures++;
+
+    BenchSinCos(15, 200000);
+    BenchSinCos(1000, 3000);
+    BenchSinCos(100000, 30);
+
+    if (BenchUpdate(15, 200000) > 4 * MAX_ERROR) failures++;
+    if (BenchUpdate(1000, 3000) > 4 * MAX_ERROR) failures++;
+    if (BenchUpdate(100000, 30) > 4 * MAX_ERROR) failures++;
+
+    return failures != 0;
+}
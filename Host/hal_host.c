@@ -0,0 +1,14 @@
+#include "main.h"
+
+// Reloj simulado: las esperas avanzan el tiempo sin dormir
+static uint32_t tick = 0;
+
+uint32_t HAL_GetTick(void)
+{
+    return tick;
+}
+
+void HAL_Delay(uint32_t delay)
+{
+    tick += delay;
+}
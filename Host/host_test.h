@@ -0,0 +1,29 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+// Cada prueba cuenta sus fallos y devuelve el total desde main
+static int failures = 0;
+
+#define CHECK(cond)  do { \
+        if (!(cond)) { \
+            printf("%s:%d: falla %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b)  do { \
+        long long check_a = (long long)(a), check_b = (long long)(b); \
+        if (check_a != check_b) { \
+            printf("%s:%d: %s = %lld, se esperaba %lld\n", __FILE__, __LINE__, #a, check_a, check_b); \
+            failures++; \
+        } \
+    } while (0)
+
+#define TEST_END()  do { \
+        printf("%s: %s\n", __FILE__, failures ? "FALLA" : "ok"); \
+        return failures != 0; \
+    } while (0)
+
+#endif
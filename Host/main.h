@@ -0,0 +1,98 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+// Sustituto de Core/Inc/main.h para compilar en el PC: solo lo que usa el código
+// portable (esperas del arranque y barreras del compilador) y, para el dispositivo
+// SPI, lo justo de GPIO, SPI1 y DMA que implementa el doble de spi_host.c
+
+#include <stdint.h>
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+
+#define __COMPILER_BARRIER()  __asm volatile ("" ::: "memory")
+
+// Petición de PendSV en el modelo de interrupciones de test_lcd_queue
+void Host_PendSV(void);
+
+// Número de la excepción en curso (0 en el bucle principal)
+extern uint32_t host_ipsr;
+#define __get_IPSR()  (host_ipsr)
+
+void Host_AssertFailed(const char* file, int line);
+#define assert_param(expr)  ((expr) ? (void)0U : Host_AssertFailed(__FILE__, __LINE__))
+
+typedef enum {
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY
+} HAL_StatusTypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct {
+    uint32_t state;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef host_gpio;
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state);
+
+#define LCD_RST_Pin        0x0002
+#define LCD_RST_GPIO_Port  (&host_gpio)
+#define LCD_RD_Pin         0x0004
+#define LCD_RD_GPIO_Port   (&host_gpio)
+#define LCD_WR_Pin         0x0008
+#define LCD_WR_GPIO_Port   (&host_gpio)
+#define LCD_RS_Pin         0x0010
+#define LCD_RS_GPIO_Port   (&host_gpio)
+#define LCD_CS_Pin         0x0020
+#define LCD_CS_GPIO_Port   (&host_gpio)
+
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+} SPI_TypeDef;
+
+typedef struct {
+    uint32_t DataSize;
+} SPI_InitTypeDef;
+
+typedef struct {
+    SPI_TypeDef* Instance;
+    SPI_InitTypeDef Init;
+} SPI_HandleTypeDef;
+
+typedef struct {
+    volatile uint32_t CR;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+    DMA_Stream_TypeDef* Instance;
+} DMA_HandleTypeDef;
+
+#define SPI_CR1_SPE          0x0040
+#define SPI_CR1_DFF          0x0800
+#define SPI_SR_TXE           0x0002
+#define SPI_SR_BSY           0x0080
+#define SPI_DATASIZE_8BIT    0x0000
+#define SPI_DATASIZE_16BIT   SPI_CR1_DFF
+#define DMA_SxCR_MINC        0x0400
+
+#define __HAL_SPI_ENABLE(h)        ((h)->Instance->CR1 |= SPI_CR1_SPE)
+#define __HAL_SPI_DISABLE(h)       ((h)->Instance->CR1 &= ~SPI_CR1_SPE)
+#define __HAL_SPI_CLEAR_OVRFLAG(h) ((void)(h))
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, const uint8_t* data, uint16_t size);
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi);
+
+// Captura de DR y del DMA para lcd_device_spi.c
+void HostSpi_WriteDR(uint16_t value);
+void HostSpi_PollDMA(void);
+#define LCD_SPI_WRITE_DR(value)  HostSpi_WriteDR(value)
+#define LCD_SPI_DMA_POLL()       HostSpi_PollDMA()
+
+#endif
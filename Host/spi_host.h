@@ -0,0 +1,31 @@
+#ifndef SPI_HOST_H
+#define SPI_HOST_H
+
+#include "main.h"
+
+// Doble de SPI1 y su DMA para lcd_device_spi.c. Cada trama que saldría por MOSI
+// llega al sumidero con el estado de D/C y su tamaño, y las ráfagas por DMA quedan
+// en curso hasta que la prueba las termina como lo haría su interrupción.
+
+#define HOST_IPSR_PENDSV  14
+#define HOST_IPSR_DMA     (16 + 59)    // DMA2_Stream3_IRQn
+
+typedef void (*HostSpiSink)(uint8_t dc, uint8_t bits, uint16_t value);
+
+typedef struct {
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t dma_transfers;
+    uint32_t cs_errors;        // Tramas con CS alto
+    uint32_t overlap_errors;   // DR o un DMA nuevo con otro DMA en curso
+    uint32_t handler_waits;    // Esperas al DMA desde una interrupción
+    uint32_t asserts;
+} HostSpiStats;
+
+void HostSpi_Init(HostSpiSink sink);
+const HostSpiStats* HostSpi_GetStats(void);
+
+// Termina la ráfaga en curso desde su interrupción; 0 si no había ninguna
+uint8_t HostSpi_CompleteDMA(void);
+
+#endif
@@ -0,0 +1,162 @@
+#include "host_test.h"
+#include <stdlib.h>
+
+// Se incluye el módulo entero para llegar a las emulaciones static de las
+// instrucciones SIMD. En el PC no hay __ARM_FEATURE_DSP: se compilan las de C.
+#include "../Graphics/blend.c"
+
+// Modelos de referencia escritos a partir del pseudocódigo del ARMv7-M ARM, con
+// los flags GE explícitos, para comparar con las emulaciones bit a bit
+static uint8_t ge;
+
+static uint32_t Ref_UHADD16(uint32_t a, uint32_t b)
+{
+    uint32_t sum1 = (a & 0xFFFF) + (b & 0xFFFF);
+    uint32_t sum2 = (a >> 16) + (b >> 16);
+    return ((sum2 >> 1) << 16) | ((sum1 >> 1) & 0xFFFF);
+}
+
+static uint32_t Ref_UADD16(uint32_t a, uint32_t b)
+{
+    uint32_t sum1 = (a & 0xFFFF) + (b & 0xFFFF);
+    uint32_t sum2 = (a >> 16) + (b >> 16);
+
+    ge = ((sum1 >= 0x10000) ? 0x3 : 0) | ((sum2 >= 0x10000) ? 0xC : 0);
+    return ((sum2 & 0xFFFF) << 16) | (sum1 & 0xFFFF);
+}
+
+static uint32_t Ref_USUB16(uint32_t a, uint32_t b)
+{
+    int32_t diff1 = (int32_t)(a & 0xFFFF) - (int32_t)(b & 0xFFFF);
+    int32_t diff2 = (int32_t)(a >> 16) - (int32_t)(b >> 16);
+
+    ge = ((diff1 >= 0) ? 0x3 : 0) | ((diff2 >= 0) ? 0xC : 0);
+    return (((uint32_t)diff2 & 0xFFFF) << 16) | ((uint32_t)diff1 & 0xFFFF);
+}
+
+// UnsignedSat de cada media palabra interpretada con signo
+static uint32_t Ref_USAT16(uint32_t x, uint8_t bits)
+{
+    uint32_t result = 0;
+
+    for (uint8_t half = 0; half < 2; half++) {
+        int32_t v = (int16_t)(x >> (16 * half));
+        int32_t max = (1 << bits) - 1;
+        int32_t sat = (v < 0) ? 0 : ((v > max) ? max : v);
+        result |= (uint32_t)sat << (16 * half);
+    }
+    return result;
+}
+
+// SEL elige byte a byte según GE[i]
+static uint32_t Ref_SEL(uint32_t a, uint32_t b)
+{
+    uint32_t result = 0;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        uint32_t mask = 0xFFU << (8 * i);
+        result |= ((ge >> i) & 1) ? (a & mask) : (b & mask);
+    }
+    return result;
+}
+
+static uint32_t Random32(void)
+{
+    return ((uint32_t)rand() << 17) ^ ((uint32_t)rand() << 5) ^ (uint32_t)rand();
+}
+
+// Todas las parejas de lanes en el rango que usa el módulo (0..63 por media palabra)
+static void TestLanesExhaustive(void)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t a = 0; a < 64 * 64; a++) {
+        uint32_t la = (a & 63) | ((a >> 6) << 16);
+
+        for (uint32_t b = 0; b < 64 * 64; b++) {
+            uint32_t lb = (b & 63) | ((b >> 6) << 16);
+
+            if (lanes_hadd(la, lb) != Ref_UHADD16(la, lb)) errors++;
+            if (lanes_add_sat5(la, lb) != Ref_USAT16(Ref_UADD16(la, lb), 5)) errors++;
+            if (lanes_add_sat6(la, lb) != Ref_USAT16(Ref_UADD16(la, lb), 6)) errors++;
+
+            uint32_t diff = Ref_USUB16(la, lb);
+            if (lanes_sub_floor(la, lb) != Ref_SEL(diff, 0)) errors++;
+        }
+    }
+
+    CHECK_EQ(errors, 0);
+}
+
+// Palabras arbitrarias: también los acarreos y signos que el módulo no genera
+static void TestLanesRandom(void)
+{
+    uint32_t errors = 0;
+
+    srand(26);
+    for (uint32_t i = 0; i < 4000000; i++) {
+        uint32_t a = Random32();
+        uint32_t b = Random32();
+
+        if (lanes_hadd(a, b) != Ref_UHADD16(a, b)) errors++;
+        if (lanes_uadd16(a, b) != Ref_UADD16(a, b)) errors++;
+        if (lanes_usat16(a, 5) != Ref_USAT16(a, 5)) errors++;
+        if (lanes_usat16(b, 6) != Ref_USAT16(b, 6)) errors++;
+
+        uint32_t diff = Ref_USUB16(a, b);
+        if (lanes_sub_floor(a, b) != Ref_SEL(diff, 0)) errors++;
+    }
+
+    CHECK_EQ(errors, 0);
+}
+
+// Funciones públicas contra el cálculo por canal de un píxel cada vez
+static uint16_t Pixel(uint32_t r, uint32_t g, uint32_t b)
+{
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void TestPixels(void)
+{
+    uint32_t errors = 0;
+
+    srand(565);
+    for (uint32_t i = 0; i < 1000000; i++) {
+        uint32_t a2 = Random32();
+        uint32_t b2 = Random32();
+        uint8_t alpha = rand() % (BLEND_ALPHA_MAX + 1);
+
+        uint32_t add = Blend_AddSat2(a2, b2);
+        uint32_t sub = Blend_SubSat2(a2, b2);
+        uint32_t avg = Blend_Average2(a2, b2);
+        uint32_t mix = Blend_RGB565x2(a2, b2, alpha);
+
+        for (uint8_t half = 0; half < 2; half++) {
+            uint16_t a = a2 >> (16 * half);
+            uint16_t b = b2 >> (16 * half);
+            uint32_t ar = a >> 11, ag = (a >> 5) & 63, ab = a & 31;
+            uint32_t br = b >> 11, bg = (b >> 5) & 63, bb = b & 31;
+
+            uint16_t add_ref = Pixel(ar + br > 31 ? 31 : ar + br, ag + bg > 63 ? 63 : ag + bg,
+                                     ab + bb > 31 ? 31 : ab + bb);
+            uint16_t sub_ref = Pixel(ar > br ? ar - br : 0, ag > bg ? ag - bg : 0, ab > bb ? ab - bb : 0);
+            uint16_t avg_ref = Pixel((ar + br) >> 1, (ag + bg) >> 1, (ab + bb) >> 1);
+
+            if ((uint16_t)(add >> (16 * half)) != add_ref) errors++;
+            if ((uint16_t)(sub >> (16 * half)) != sub_ref) errors++;
+            if ((uint16_t)(avg >> (16 * half)) != avg_ref) errors++;
+            if ((uint16_t)(mix >> (16 * half)) != Blend_RGB565(a, b, alpha)) errors++;
+        }
+    }
+
+    CHECK_EQ(errors, 0);
+}
+
+int main(void)
+{
+    TestLanesExhaustive();
+    TestLanesRandom();
+    TestPixels();
+
+    TEST_END();
+}
@@ -0,0 +1,291 @@
+#include "host_test.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include <math.h>
+
+// Tráfico de LCD_DrawPixel con la ventana y el puntero de RAMWR seguidos por el
+// driver. Sin seguimiento cada píxel costaba CASET + PASET + RAMWR: 3 comandos y
+// 13 bytes. Ahora el píxel en el puntero cuesta 2 bytes y si no, solo se reenvía
+// el eje que cambió.
+
+#define BYTES_FULL   13   // CASET(5) + PASET(5) + RAMWR(1) + color(2)
+#define BYTES_AXIS   8    // Un eje(5) + RAMWR(1) + color(2)
+#define BYTES_CURSOR 2
+
+typedef void (*PixelFn)(int16_t x, int16_t y, uint16_t color);
+
+// Referencia: cada píxel en su propia ventana de 1x1
+static void PixelAsRect(int16_t x, int16_t y, uint16_t color)
+{
+    LCD_FillRect(x, y, 1, 1, color);
+}
+
+// 80 estrellas, una de cada 5 con vecinas a la derecha y debajo. Entre estrellas
+// seguidas cambian x e y: la vecina derecha cae en el puntero y la de debajo
+// solo reenvía PASET.
+static void DrawStars(PixelFn pixel)
+{
+    for (int16_t i = 0; i < 80; i++) {
+        int16_t x = (i * 37 + 11) % 300;
+        int16_t y = (i * 53 + 7) % 230;
+
+        pixel(x, y, COLOR_WHITE);
+        if (i % 5 == 0) {
+            pixel(x + 1, y, COLOR_WHITE);
+            pixel(x, y + 1, COLOR_WHITE);
+        }
+    }
+}
+
+// Elipse de 100 puntos dibujados de dos en dos
+static void DrawOrbit(PixelFn pixel)
+{
+    for (int16_t j = 0; j < 100; j++) {
+        int16_t x = 160 + 100 * cos(j * 0.0628);
+        int16_t y = 120 + 50 * sin(j * 0.0628);
+
+        pixel(x, y, 0x632C);
+        pixel(x + 1, y, 0x632C);
+    }
+}
+
+// Circunferencia de r = 40 en el mismo orden que LCD_DrawCircle (punto medio, 8 octantes)
+static void DrawCircle(PixelFn pixel)
+{
+    int16_t x0 = 100, y0 = 100, r = 40;
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    pixel(x0, y0 + r, COLOR_RED);
+    pixel(x0, y0 - r, COLOR_RED);
+    pixel(x0 + r, y0, COLOR_RED);
+    pixel(x0 - r, y0, COLOR_RED);
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        pixel(x0 + x, y0 + y, COLOR_RED);
+        pixel(x0 - x, y0 + y, COLOR_RED);
+        pixel(x0 + x, y0 - y, COLOR_RED);
+        pixel(x0 - x, y0 - y, COLOR_RED);
+        pixel(x0 + y, y0 + x, COLOR_RED);
+        pixel(x0 - y, y0 + x, COLOR_RED);
+        pixel(x0 + y, y0 - x, COLOR_RED);
+        pixel(x0 - y, y0 - x, COLOR_RED);
+    }
+}
+
+static void ResetCounters(void)
+{
+    LCD_ResetBusStats();
+    LCDTrace_Reset();
+}
+
+static void CheckTraffic(uint32_t commands, uint32_t bytes)
+{
+    CHECK_EQ(LCD_GetBusStats()->commands, commands);
+    CHECK_EQ(LCD_GetBusStats()->bytes, bytes);
+    CHECK_EQ(LCDTrace_GetStats()->bytes, bytes);
+}
+
+// Sin seguimiento: (80 + 32) * 3 = 336 comandos y 1120 bytes de datos
+static void TestStars(void)
+{
+    LCD_Clear(COLOR_BLACK);
+    ResetCounters();
+    DrawStars(LCD_DrawPixel);
+
+    CheckTraffic(80 * 3 + 16 * 2, 80 * BYTES_FULL + 16 * (BYTES_CURSOR + BYTES_AXIS));
+    CHECK_EQ(LCD_GetBusStats()->pixels_streamed, 16);
+    CHECK_EQ(LCD_GetBusStats()->caset_skipped, 16);
+    CHECK_EQ(LCD_GetBusStats()->commands, 272);
+    CHECK_EQ(LCD_GetBusStats()->bytes - LCD_GetBusStats()->commands, 928);
+}
+
+// Sin seguimiento: 200 * 3 = 600 comandos y 2000 bytes de datos
+static void TestOrbit(void)
+{
+    LCD_Clear(COLOR_BLACK);
+    ResetCounters();
+    DrawOrbit(LCD_DrawPixel);
+
+    const LCDBusStats* bus = LCD_GetBusStats();
+
+    // La segunda de cada pareja siempre va en el puntero
+    CHECK_EQ(bus->pixels_streamed, 100);
+    CHECK_EQ(bus->commands, 282);
+    CHECK_EQ(bus->bytes - bus->commands, 1128);
+
+    // Cada primer píxel: 3 comandos, o 2 si se salta un eje
+    uint32_t skipped = bus->caset_skipped + bus->paset_skipped;
+    CHECK_EQ(bus->commands, 100 * 3 - skipped);
+    CheckTraffic(282, 100 * BYTES_FULL - skipped * 5 + 100 * BYTES_CURSOR);
+}
+
+static uint32_t pixel_count;
+
+static void CountPixel(int16_t x, int16_t y, uint16_t color)
+{
+    pixel_count++;
+}
+
+// Circunferencia de LCD_DrawCircle. Las cifras de circunferencias y líneas del cambio
+// (2565 comandos a 1349) incluían líneas por píxel, que ahora van por tramos.
+static void TestCircle(void)
+{
+    pixel_count = 0;
+    DrawCircle(CountPixel);
+
+    LCD_Clear(COLOR_BLACK);
+    ResetCounters();
+    LCD_DrawCircle(100, 100, 40, COLOR_RED);
+
+    const LCDBusStats* bus = LCD_GetBusStats();
+    uint32_t skipped = bus->caset_skipped + bus->paset_skipped;
+
+    // Sin seguimiento 708 comandos. Los octantes saltan de un lado a otro y casi
+    // ningún píxel cae en el puntero, pero los simétricos comparten fila o columna.
+    CHECK_EQ(pixel_count, 4 + 8 * 29);
+    CHECK_EQ(bus->commands, 590);
+    CHECK_EQ(bus->commands, (pixel_count - bus->pixels_streamed) * 3 - skipped);
+    CheckTraffic(590, pixel_count * BYTES_FULL - skipped * 5 -
+                      bus->pixels_streamed * (BYTES_FULL - BYTES_CURSOR));
+}
+
+// Píxeles seguidos en la misma fila van en el puntero; al llegar al borde derecho
+// el puntero vuelve a la columna de la ventana en la fila siguiente
+static void TestCursor(void)
+{
+    ResetCounters();
+    LCD_DrawPixel(30, 10, 1);
+    LCD_DrawPixel(31, 10, 2);
+    LCD_DrawPixel(32, 10, 3);
+    CheckTraffic(3, BYTES_FULL + 2 * BYTES_CURSOR);
+
+    ResetCounters();
+    LCD_DrawPixel(318, 50, 4);
+    LCD_DrawPixel(319, 50, 5);
+    LCD_DrawPixel(318, 51, 6);
+    CheckTraffic(3, BYTES_FULL + 2 * BYTES_CURSOR);
+    CHECK_EQ(LCD_GetBusStats()->pixels_streamed, 2);
+    CHECK_EQ(LCDFB_GetPixel(318, 51), 6);
+
+    // Solo cambia la fila: PASET y RAMWR
+    ResetCounters();
+    LCD_DrawPixel(318, 60, 7);
+    CheckTraffic(2, BYTES_AXIS);
+
+    // Cualquier otro comando olvida la ventana
+    LCD_SetInversion(0);
+    ResetCounters();
+    LCD_DrawPixel(318, 61, 8);
+    CheckTraffic(3, BYTES_FULL);
+}
+
+// Lo que se pinta no depende del camino: igual que con una ventana por píxel
+static uint16_t expected[LCD_HEIGHT][LCD_WIDTH];
+
+static void CheckSamePixels(void (*draw)(PixelFn))
+{
+    LCD_Clear(COLOR_BLACK);
+    draw(PixelAsRect);
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            expected[y][x] = LCDFB_GetPixel(x, y);
+        }
+    }
+
+    LCD_Clear(COLOR_BLACK);
+    draw(LCD_DrawPixel);
+
+    uint32_t errors = 0;
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            if (LCDFB_GetPixel(x, y) != expected[y][x]) errors++;
+        }
+    }
+    CHECK_EQ(errors, 0);
+}
+
+// Media luna de LCD_FillDiscDifference contra la diferencia de los dos discos
+// punto a punto: dentro de (ax, ay, ar) y fuera de (bx, by, br)
+static uint8_t InDisc(int32_t x, int32_t y, int32_t cx, int32_t cy, int32_t r)
+{
+    return r >= 0 && (x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r;
+}
+
+static void CheckDiscDifference(int16_t ax, int16_t ay, int16_t ar, int16_t bx, int16_t by, int16_t br)
+{
+    uint32_t errors = 0;
+    uint32_t area = 0;
+
+    LCD_Clear(COLOR_BLACK);
+    ResetCounters();
+    LCD_FillDiscDifference(ax, ay, ar, bx, by, br, COLOR_WHITE);
+
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            uint8_t inside = InDisc(x, y, ax, ay, ar) && !InDisc(x, y, bx, by, br);
+
+            area += inside;
+            if (LCDFB_GetPixel(x, y) != (inside ? COLOR_WHITE : COLOR_BLACK)) errors++;
+        }
+    }
+    CHECK_EQ(errors, 0);
+
+    // Cada píxel de la media luna se envía una sola vez
+    CHECK_EQ(LCDTrace_GetStats()->pixels, area);
+}
+
+static void TestDiscDifference(void)
+{
+    CheckDiscDifference(160, 120, 40, 163, 121, 40);      // Movido: dos tramos finos por fila
+    CheckDiscDifference(160, 120, 40, 160, 120, 31);      // Encogido: anillo
+    CheckDiscDifference(160, 120, 40, 150, 125, 12);      // Encogido y movido
+    CheckDiscDifference(60, 60, 30, 250, 180, 30);        // Separados: el disco entero
+    CheckDiscDifference(160, 120, 20, 160, 120, 50);      // El nuevo lo tapa: nada
+    CheckDiscDifference(160, 120, 25, 0, 0, -1);          // Sin disco nuevo
+    CheckDiscDifference(5, 3, 30, 12, -4, 28);            // Recortados en la esquina
+    CheckDiscDifference(310, 230, 45, 330, 250, 45);      // El nuevo casi fuera de pantalla
+    CheckDiscDifference(160, -30, 50, 160, 300, 50);      // Solo la parte de abajo de A
+
+    // El anillo es la diferencia de dos discos concéntricos
+    LCD_Clear(COLOR_BLACK);
+    LCD_FillAnnulus(100, 100, 20, 35, COLOR_WHITE);
+    uint32_t errors = 0;
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            uint8_t inside = InDisc(x, y, 100, 100, 35) && !InDisc(x, y, 100, 100, 20);
+            if (LCDFB_GetPixel(x, y) != (inside ? COLOR_WHITE : COLOR_BLACK)) errors++;
+        }
+    }
+    CHECK_EQ(errors, 0);
+}
+
+int main(void)
+{
+    LCD_SetDevice(&lcd_trace_device);
+    LCDTrace_Attach(&lcd_fb_device);
+    LCD_Init();
+
+    TestStars();
+    TestOrbit();
+    TestCircle();
+    TestCursor();
+    TestDiscDifference();
+
+    CheckSamePixels(DrawStars);
+    CheckSamePixels(DrawOrbit);
+    CheckSamePixels(DrawCircle);
+
+    TEST_END();
+}
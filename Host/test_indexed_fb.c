@@ -0,0 +1,179 @@
+#include "host_test.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include "../Graphics/compositor.h"
+#include "../Graphics/indexed_fb.h"
+
+// Framebuffer indexado con INDEXED_FB_ENABLE = 1 (Makefile) sobre lcd_device_fb a
+// través de la traza: el compositor escribe en él y solo Flush llega al panel.
+
+// Colores con claves RGB444 distintas, incluidos bits bajos que la clave descarta
+static const uint16_t colors[] = {
+    0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x1234, 0x8410, 0xF81F,
+    0x18E3, 0xFFE0, 0x4A69, 0xC618, 0x7BEF, 0x2104, 0xFD40, 0x047F
+};
+
+#define COLOR_COUNT  (sizeof(colors) / sizeof(colors[0]))
+
+static uint16_t image[INDEXED_FB_HEIGHT][INDEXED_FB_WIDTH];
+static uint8_t shift;
+
+static uint16_t Source(int16_t x, int16_t y)
+{
+    return colors[(x / 8 + y / 4 + shift) % COLOR_COUNT];
+}
+
+static void Fill(void)
+{
+    for (int16_t y = 0; y < INDEXED_FB_HEIGHT; y++) {
+        for (int16_t x = 0; x < INDEXED_FB_WIDTH; x++) {
+            image[y][x] = Source(x, y);
+        }
+    }
+}
+
+static uint32_t PanelErrors(void)
+{
+    uint32_t errors = 0;
+
+    for (int16_t y = 0; y < INDEXED_FB_HEIGHT; y++) {
+        for (int16_t x = 0; x < INDEXED_FB_WIDTH; x++) {
+            if (LCDFB_GetPixel(x, y) != image[y][x]) errors++;
+        }
+    }
+    return errors;
+}
+
+// Ventanas enviadas desde el último LCDTrace_Reset fuera de las filas [y0, y1]
+static uint32_t WindowsOutside(int16_t y0, int16_t y1)
+{
+    uint32_t outside = 0;
+
+    for (uint16_t i = 0; i < LCDTrace_Count(); i++) {
+        const LCDTraceEntry* e = LCDTrace_Entry(i);
+        if (e->op == LCD_TRACE_WINDOW && (e->y0 < y0 || e->y1 > y1)) outside++;
+    }
+    return outside;
+}
+
+static void SourceLayer(void* ctx, CompositorTile* tile)
+{
+    for (int16_t y = 0; y < tile->h; y++) {
+        for (int16_t x = 0; x < tile->w; x++) {
+            tile->pixels[y * tile->w + x] = Source(tile->x + x, tile->y + y);
+        }
+    }
+}
+
+// Los colores de la paleta vuelven exactos al panel, con todos sus bits
+static void TestPalette(void)
+{
+    LCD_Clear(0x5555);
+    IndexedFB_Init();
+    IndexedFB_SetPalette(colors, COLOR_COUNT);
+
+    for (uint16_t i = 0; i < COLOR_COUNT; i++) {
+        CHECK_EQ(IndexedFB_Quantize(colors[i]), i);
+    }
+
+    // Casi negro sin entrada propia: el más cercano
+    CHECK_EQ(IndexedFB_Quantize(0x0020), 0);
+
+    shift = 0;
+    Fill();
+    IndexedFB_WriteRect(0, 0, INDEXED_FB_WIDTH, INDEXED_FB_HEIGHT, &image[0][0]);
+
+    // Nada llega al panel hasta Flush
+    LCDTrace_Reset();
+    CHECK_EQ(PanelErrors(), (uint32_t)INDEXED_FB_WIDTH * INDEXED_FB_HEIGHT);
+    IndexedFB_Flush();
+    CHECK_EQ(LCDTrace_GetStats()->pixels, (uint32_t)INDEXED_FB_WIDTH * INDEXED_FB_HEIGHT);
+    CHECK_EQ(PanelErrors(), 0);
+
+    // La misma paleta no reconstruye ni reenvía nada
+    IndexedFB_SetPalette(colors, COLOR_COUNT);
+    LCDTrace_Reset();
+    IndexedFB_Flush();
+    CHECK_EQ(LCDTrace_GetStats()->pixels, 0);
+}
+
+// Solo se envían las filas que cambiaron, de la primera a la última columna cambiada
+static void TestDirtyRows(void)
+{
+    IndexedFB_WriteRect(0, 0, INDEXED_FB_WIDTH, INDEXED_FB_HEIGHT, &image[0][0]);
+    LCDTrace_Reset();
+    IndexedFB_Flush();
+    CHECK_EQ(LCDTrace_GetStats()->pixels, 0);
+
+    // Cuatro filas seguidas comparten ventana; la fila suelta lleva la suya
+    for (int16_t y = 100; y < 104; y++) {
+        for (int16_t x = 40; x < 60; x++) {
+            image[y][x] = colors[5];
+        }
+    }
+    image[200][7] = colors[7];
+    image[200][300] = colors[5];
+
+    IndexedFB_WriteRect(0, 0, INDEXED_FB_WIDTH, INDEXED_FB_HEIGHT, &image[0][0]);
+    LCDTrace_Reset();
+    IndexedFB_Flush();
+
+    CHECK_EQ(LCDTrace_GetStats()->pixels, 4 * 20 + (300 - 7 + 1));
+    CHECK_EQ(LCDTrace_GetStats()->windows, 2);
+    CHECK_EQ(PanelErrors(), 0);
+
+    // Una región recortada por los bordes solo ensucia lo que queda dentro
+    IndexedFB_MarkDirty(-10, 230, 30, 40);
+    LCDTrace_Reset();
+    IndexedFB_Flush();
+    CHECK_EQ(LCDTrace_GetStats()->pixels, 20 * 10);
+    CHECK_EQ(WindowsOutside(230, 239), 0);
+}
+
+// El compositor escribe en el framebuffer por defecto y Compositor_Invalidate hace
+// que se reenvíe lo que el panel perdió
+static void TestCompositor(void)
+{
+    // Compositor_Init invalida toda la pantalla: se reenvía una vez
+    Compositor_Init(colors[0]);
+    Compositor_AddLayer(SourceLayer, NULL);
+    IndexedFB_Flush();
+
+    shift = 3;
+    Fill();
+
+    LCDTrace_Reset();
+    Compositor_RenderRect(64, 120, 32, 8);
+    CHECK_EQ(LCDTrace_GetStats()->pixels, 0);
+
+    for (int16_t y = 0; y < INDEXED_FB_HEIGHT; y++) {
+        for (int16_t x = 0; x < INDEXED_FB_WIDTH; x++) {
+            if (y < 120 || y >= 128 || x < 64 || x >= 96) image[y][x] = LCDFB_GetPixel(x, y);
+        }
+    }
+
+    IndexedFB_Flush();
+    CHECK_EQ(WindowsOutside(120, 127), 0);
+    CHECK(LCDTrace_GetStats()->pixels <= 8 * 32);
+    CHECK_EQ(PanelErrors(), 0);
+
+    // El panel pierde una franja: se repone desde el framebuffer sin recomponer
+    LCD_FillRect(0, 10, INDEXED_FB_WIDTH, 2, 0x5555);
+    Compositor_Invalidate(0, 10, INDEXED_FB_WIDTH, 2);
+    LCDTrace_Reset();
+    IndexedFB_Flush();
+    CHECK_EQ(LCDTrace_GetStats()->pixels, 2 * INDEXED_FB_WIDTH);
+    CHECK_EQ(PanelErrors(), 0);
+}
+
+int main(void)
+{
+    LCD_SetDevice(&lcd_trace_device);
+    LCDTrace_Attach(&lcd_fb_device);
+    LCD_Init();
+
+    TestPalette();
+    TestDirtyRows();
+    TestCompositor();
+
+    TEST_END();
+}
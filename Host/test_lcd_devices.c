@@ -0,0 +1,112 @@
+#include "host_test.h"
+#include "../Drivers/LCD/lcd_driver.h"
+
+// El driver sobre el registro de tráfico, que reenvía al framebuffer: lo que se
+// dibuja tiene que aparecer en la RAM emulada y el registro tiene que contar
+// exactamente los bytes que el driver cree haber enviado.
+
+static uint32_t CountColor(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    uint32_t count = 0;
+
+    for (int16_t j = y; j < y + h; j++) {
+        for (int16_t i = x; i < x + w; i++) {
+            if (LCDFB_GetPixel(i, j) == color) count++;
+        }
+    }
+    return count;
+}
+
+static void TestPrimitives(void)
+{
+    LCD_Clear(COLOR_BLUE);
+    CHECK_EQ(CountColor(0, 0, LCD_WIDTH, LCD_HEIGHT, COLOR_BLUE), (uint32_t)LCD_WIDTH * LCD_HEIGHT);
+
+    LCD_FillRect(10, 20, 30, 40, COLOR_RED);
+    CHECK_EQ(CountColor(10, 20, 30, 40, COLOR_RED), 30 * 40);
+    CHECK_EQ(CountColor(0, 0, LCD_WIDTH, LCD_HEIGHT, COLOR_RED), 30 * 40);
+
+    // Recortado contra el borde
+    LCD_FillRect(LCD_WIDTH - 5, LCD_HEIGHT - 5, 20, 20, COLOR_GREEN);
+    CHECK_EQ(CountColor(0, 0, LCD_WIDTH, LCD_HEIGHT, COLOR_GREEN), 25);
+
+    uint16_t bitmap[4 * 3];
+    for (uint16_t i = 0; i < 12; i++) {
+        bitmap[i] = 0x1000 + i;
+    }
+    LCD_DrawBitmap(100, 100, 4, 3, bitmap);
+    for (uint16_t i = 0; i < 12; i++) {
+        CHECK_EQ(LCDFB_GetPixel(100 + i % 4, 100 + i / 4), 0x1000 + i);
+    }
+
+    // Disco: dx² + dy² <= r²
+    LCD_Clear(COLOR_BLACK);
+    LCD_FillCircle(160, 120, 10, COLOR_WHITE);
+    uint32_t inside = 0;
+    for (int16_t dy = -10; dy <= 10; dy++) {
+        for (int16_t dx = -10; dx <= 10; dx++) {
+            if (dx * dx + dy * dy <= 100) inside++;
+        }
+    }
+    CHECK_EQ(CountColor(0, 0, LCD_WIDTH, LCD_HEIGHT, COLOR_WHITE), inside);
+    CHECK_EQ(LCDFB_GetPixel(160, 110), COLOR_WHITE);
+    CHECK_EQ(LCDFB_GetPixel(168, 113), COLOR_BLACK);
+
+    LCD_DrawPixel(5, 5, COLOR_YELLOW);
+    CHECK_EQ(LCDFB_GetPixel(5, 5), COLOR_YELLOW);
+}
+
+static void TestTraceMatchesDriver(void)
+{
+    LCD_ResetBusStats();
+    LCDTrace_Reset();
+
+    LCD_FillRect(0, 0, 16, 16, COLOR_RED);
+    LCD_DrawLine(0, 0, 100, 50, COLOR_WHITE);
+    LCD_FillCircle(200, 100, 30, COLOR_CYAN);
+
+    const LCDBusStats* bus = LCD_GetBusStats();
+    const LCDTraceStats* trace = LCDTrace_GetStats();
+
+    CHECK_EQ(trace->bytes, bus->bytes);
+    CHECK(trace->pixels >= 16 * 16);
+
+    // Un rectángulo: ventana completa, ráfaga de color y fin
+    LCDTrace_Reset();
+    LCD_FillRect(50, 60, 7, 9, COLOR_GREEN);
+
+    CHECK_EQ(LCDTrace_Count(), 3);
+    CHECK_EQ(LCDTrace_Entry(0)->op, LCD_TRACE_WINDOW);
+    CHECK_EQ(LCDTrace_Entry(1)->op, LCD_TRACE_COLOR);
+    CHECK_EQ(LCDTrace_Entry(1)->count, 7 * 9);
+    CHECK_EQ(LCDTrace_Entry(2)->op, LCD_TRACE_END);
+    CHECK_EQ(trace->pixels, 7 * 9);
+}
+
+// Sin dispositivo enganchado el registro hace de panel nulo
+static void TestNullPanel(void)
+{
+    LCD_Clear(COLOR_BLACK);
+    LCDTrace_Attach(0);
+    LCDTrace_Reset();
+
+    LCD_FillRect(0, 0, 40, 40, COLOR_RED);
+
+    CHECK_EQ(LCDTrace_GetStats()->pixels, 40 * 40);
+    CHECK_EQ(CountColor(0, 0, 40, 40, COLOR_RED), 0);
+
+    LCDTrace_Attach(&lcd_fb_device);
+}
+
+int main(void)
+{
+    LCD_SetDevice(&lcd_trace_device);
+    LCDTrace_Attach(&lcd_fb_device);
+    LCD_Init();
+
+    TestPrimitives();
+    TestTraceMatchesDriver();
+    TestNullPanel();
+
+    TEST_END();
+}
@@ -0,0 +1,322 @@
+#include "host_test.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include "../Drivers/LCD/lcd_queue.h"
+#include <string.h>
+
+// Modelo de las interrupciones del firmware para la cola del LCD:
+//  - PendSV (prioridad 15) no interrumpe a otra interrupción: si se pide desde
+//    una, queda pendiente y entra al salir de ella. Desde el bucle principal entra
+//    en el acto.
+//  - El fin de DMA (prioridad 5) sí interrumpe a PendSV. Aquí llega en los puntos
+//    en que el consumidor consulta si el bus está ocupado.
+//  - Cada vuelta de espera del bucle principal deja pasar un ciclo del DMA.
+// El dispositivo de prueba graba lo que recibe y tarda dma_length ciclos en cada
+// ráfaga de píxeles.
+
+#define LOG_SIZE  1024
+
+typedef struct {
+    uint8_t op;
+    uint16_t value;
+    uint32_t count;
+    const uint16_t* pixels;
+} LogEntry;
+
+enum { OP_WINDOW = 1, OP_PIXELS, OP_COLOR, OP_END };
+
+static LogEntry log_entries[LOG_SIZE];
+static uint32_t log_count;
+
+static uint8_t in_pendsv;
+static uint8_t in_dma_irq;
+static uint8_t pendsv_pending;
+static uint32_t pendsv_runs;
+static uint32_t reentries;
+static uint32_t handler_waits;
+static uint32_t overlaps;
+
+static uint8_t dma_active;
+static uint32_t dma_left;
+static uint32_t dma_length = 3;
+
+static void Log(uint8_t op, uint16_t value, uint32_t count, const uint16_t* pixels)
+{
+    if (log_count < LOG_SIZE) {
+        log_entries[log_count].op = op;
+        log_entries[log_count].value = value;
+        log_entries[log_count].count = count;
+        log_entries[log_count].pixels = pixels;
+    }
+    log_count++;
+}
+
+static void RunPendSV(void)
+{
+    if (in_pendsv) reentries++;
+
+    // Encadenado: si se vuelve a pedir mientras corre, entra otra vez al salir
+    do {
+        pendsv_pending = 0;
+        in_pendsv = 1;
+        pendsv_runs++;
+        LCDQueue_Service();
+        in_pendsv = 0;
+    } while (pendsv_pending);
+}
+
+// LCD_QUEUE_PEND
+void Host_PendSV(void)
+{
+    if (in_pendsv || in_dma_irq) {
+        pendsv_pending = 1;
+        return;
+    }
+    RunPendSV();
+}
+
+static void DmaIrq(void)
+{
+    in_dma_irq = 1;
+    dma_active = 0;
+    LCDQueue_Resume();
+    in_dma_irq = 0;
+
+    // Al volver al bucle principal entra PendSV si quedó pendiente
+    if (!in_pendsv && pendsv_pending) RunPendSV();
+}
+
+static void DmaCycle(void)
+{
+    if (dma_active && --dma_left == 0) DmaIrq();
+}
+
+static void TestInit(void)
+{
+}
+
+static void TestCommand(uint8_t cmd, const uint8_t* params, uint8_t count)
+{
+}
+
+static void TestWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t resend)
+{
+    Log(OP_WINDOW, x0, y0, 0);     // count: fila de inicio
+}
+
+static void TestPixels(const uint16_t* pixels, uint32_t count)
+{
+    if (dma_active) overlaps++;   // Una ráfaga encima de otra
+    Log(OP_PIXELS, pixels[0], count, pixels);
+    dma_active = 1;
+    dma_left = dma_length;
+}
+
+static void TestColor(uint16_t color, uint32_t count)
+{
+    Log(OP_COLOR, color, count, 0);
+}
+
+static void TestEnd(void)
+{
+    Log(OP_END, 0, 0, 0);
+}
+
+// Esperar a que termine el DMA desde una interrupción bloquearía el sistema
+static void TestFlush(void)
+{
+    if (in_pendsv || in_dma_irq) {
+        handler_waits++;
+        return;
+    }
+    while (dma_active) DmaCycle();
+}
+
+// Mientras PendSV mira el bus puede llegar el fin de DMA
+static uint8_t TestBusy(void)
+{
+    if (in_pendsv) DmaCycle();
+    return dma_active;
+}
+
+static const LCDDevice test_device = {
+    TestInit, TestCommand, TestWindow, TestPixels, TestColor, TestEnd, TestFlush, TestBusy
+};
+
+static void Reset(uint32_t length)
+{
+    LCDQueue_Flush();
+    while (dma_active) DmaCycle();
+
+    LCDQueue_Init();
+    log_count = 0;
+    pendsv_runs = 0;
+    reentries = 0;
+    handler_waits = 0;
+    overlaps = 0;
+    dma_length = length;
+}
+
+// Bucle principal: LCDQueue_WaitFence pide PendSV en cada vuelta; aquí además pasa el tiempo
+static void WaitFence(uint32_t fence)
+{
+    while (!LCDQueue_FenceDone(fence)) {
+        DmaCycle();
+        LCDQueue_WaitFence(fence);
+    }
+}
+
+// Lo que sale por el bus, en el orden en que se encoló
+static void TestOrder(void)
+{
+    static uint16_t rows[4][8];
+
+    Reset(3);
+
+    for (uint16_t i = 0; i < 4; i++) {
+        for (uint16_t j = 0; j < 8; j++) {
+            rows[i][j] = 0x100 * i + j;
+        }
+        LCDQueue_Window(0, i, 7, i);
+        LCDQueue_Pixels(rows[i], 8);
+        LCDQueue_End();
+        LCDQueue_Color(0xA000 + i, 5);
+    }
+    WaitFence(LCDQueue_Fence());
+
+    CHECK_EQ(log_count, 4 * 4);
+    for (uint16_t i = 0; i < 4 && log_count == 16; i++) {
+        const LogEntry* e = &log_entries[i * 4];
+
+        CHECK_EQ(e[0].op, OP_WINDOW);
+        CHECK_EQ(e[0].count, i);
+        CHECK_EQ(e[1].op, OP_PIXELS);
+        CHECK(e[1].pixels == rows[i]);
+        CHECK_EQ(e[1].count, 8);
+        CHECK_EQ(e[2].op, OP_END);
+        CHECK_EQ(e[3].op, OP_COLOR);
+        CHECK_EQ(e[3].value, 0xA000 + i);
+    }
+
+    CHECK_EQ(reentries, 0);
+    CHECK_EQ(handler_waits, 0);
+    CHECK_EQ(overlaps, 0);
+}
+
+// Una barrera se cumple cuando todo lo anterior salió del bus, y no antes
+static void TestFences(void)
+{
+    static uint16_t band[2][64];
+
+    Reset(10);
+
+    memset(band, 0x11, sizeof(band));
+    LCDQueue_Window(0, 0, 63, 0);
+    LCDQueue_Pixels(band[0], 64);
+    LCDQueue_End();
+    uint32_t first = LCDQueue_Fence();
+
+    // La ráfaga está en marcha: el productor puede seguir mientras dura
+    CHECK(!LCDQueue_FenceDone(first));
+    CHECK_EQ(log_count, 2);
+
+    LCDQueue_Window(0, 1, 63, 1);
+    LCDQueue_Pixels(band[1], 64);
+    LCDQueue_End();
+    uint32_t second = LCDQueue_Fence();
+
+    WaitFence(first);
+    CHECK(LCDQueue_FenceDone(first));
+
+    // Lo que va detrás de la primera barrera no se da por enviado
+    WaitFence(second);
+    CHECK(LCDQueue_FenceDone(second));
+    CHECK(LCDQueue_FenceDone(first));
+    CHECK_EQ(log_count, 6);
+    CHECK(!dma_active);
+
+    CHECK_EQ(reentries, 0);
+    CHECK_EQ(handler_waits, 0);
+    CHECK_EQ(overlaps, 0);
+}
+
+// Con el anillo lleno el productor espera a que el consumidor libere sitio, sin
+// pisar entradas ni perder el orden
+static void TestBackPressure(void)
+{
+    static uint16_t pixels[3 * LCD_QUEUE_SIZE];
+    uint32_t sent = 0;
+
+    Reset(7);
+
+    for (uint32_t i = 0; i < 3 * LCD_QUEUE_SIZE; i++) {
+        pixels[i] = i;
+        LCDQueue_Pixels(&pixels[i], 1);
+        DmaCycle();
+    }
+    WaitFence(LCDQueue_Fence());
+
+    CHECK_EQ(log_count, 3 * LCD_QUEUE_SIZE);
+    for (uint32_t i = 0; i < log_count && i < LOG_SIZE; i++) {
+        if (log_entries[i].op == OP_PIXELS && log_entries[i].value == i) sent++;
+    }
+    CHECK_EQ(sent, 3 * LCD_QUEUE_SIZE);
+    CHECK_EQ(reentries, 0);
+    CHECK_EQ(handler_waits, 0);
+    CHECK_EQ(overlaps, 0);
+}
+
+// Sin nadie esperando: el fin de cada ráfaga es lo único que hace avanzar la cola
+static void TestResume(void)
+{
+    static uint16_t a[4], b[4], c[4];
+
+    Reset(3);
+
+    LCDQueue_Pixels(a, 4);
+    LCDQueue_Pixels(b, 4);
+    LCDQueue_Pixels(c, 4);
+    uint32_t fence = LCDQueue_Fence();
+
+    CHECK_EQ(log_count, 1);
+    for (uint8_t i = 0; i < 3 * 3; i++) {
+        DmaCycle();
+    }
+
+    CHECK(LCDQueue_FenceDone(fence));
+    CHECK_EQ(log_count, 3);
+    CHECK_EQ(overlaps, 0);
+}
+
+// El fin de DMA llega justo cuando PendSV comprueba el bus: la petición que hace
+// queda pendiente y se atiende al salir, sin perderse
+static void TestLateCompletion(void)
+{
+    static uint16_t a[4], b[4];
+
+    Reset(1);
+
+    LCDQueue_Pixels(a, 4);
+    LCDQueue_Pixels(b, 4);
+    uint32_t fence = LCDQueue_Fence();
+
+    // Sin esperas del bucle principal: todo avanza desde las interrupciones
+    CHECK(LCDQueue_FenceDone(fence));
+    CHECK_EQ(log_count, 2);
+    CHECK(pendsv_runs >= 2);
+    CHECK_EQ(reentries, 0);
+    CHECK_EQ(overlaps, 0);
+}
+
+int main(void)
+{
+    LCD_SetDevice(&test_device);
+    LCD_Init();
+
+    TestOrder();
+    TestFences();
+    TestBackPressure();
+    TestResume();
+    TestLateCompletion();
+
+    TEST_END();
+}
@@ -0,0 +1,108 @@
+#include "host_test.h"
+#include "../SolarSystem/nbody.h"
+#include <math.h>
+
+// Octree de Barnes–Hut con NBODY_MAX_DEPTH = 2 (Makefile): 64 hojas, así que dos
+// cuerpos en la misma celda comparten hoja como lo harían dos casi coincidentes a
+// profundidad 24. Con theta = 0 se abren todos los nodos internos.
+
+#define GRID       4
+#define BODIES     (GRID * GRID * GRID + 1)
+#define SHARED     (BODIES - 1)      // Segundo cuerpo de la hoja compartida
+#define PARTNER    21                // El primero: el de la celda (-1, -1, -1)
+
+static float pos_x[BODIES], pos_y[BODIES], pos_z[BODIES];
+static float vel_x[BODIES], vel_y[BODIES], vel_z[BODIES];
+static float mass[BODIES];
+
+// Un cuerpo en el centro de cada celda (coordenadas ±1 y ±3) y otro más junto al
+// de (-1, -1, -1), en su misma celda
+static void Setup(void)
+{
+    uint32_t n = 0;
+
+    for (int8_t i = 0; i < GRID; i++) {
+        for (int8_t j = 0; j < GRID; j++) {
+            for (int8_t k = 0; k < GRID; k++) {
+                pos_x[n] = 2 * i - 3;
+                pos_y[n] = 2 * j - 3;
+                pos_z[n] = 2 * k - 3;
+                n++;
+            }
+        }
+    }
+
+    pos_x[n] = pos_x[PARTNER] + 0.3f;
+    pos_y[n] = pos_y[PARTNER] + 0.2f;
+    pos_z[n] = pos_z[PARTNER] + 0.25f;
+
+    for (uint32_t i = 0; i < BODIES; i++) {
+        vel_x[i] = vel_y[i] = vel_z[i] = 0.0f;
+        mass[i] = 1.0f + i % 5;
+    }
+}
+
+static void DirectAcceleration(const NBodySet* set, uint32_t i, double* a)
+{
+    double eps2 = (double)set->softening * set->softening;
+
+    a[0] = a[1] = a[2] = 0.0;
+    for (uint32_t j = 0; j < set->count; j++) {
+        if (j == i) continue;
+
+        double dx = pos_x[j] - pos_x[i];
+        double dy = pos_y[j] - pos_y[i];
+        double dz = pos_z[j] - pos_z[i];
+        double r = sqrt(dx * dx + dy * dy + dz * dz + eps2);
+        double f = set->gravity * mass[j] / (r * r * r);
+
+        a[0] += f * dx;
+        a[1] += f * dy;
+        a[2] += f * dz;
+    }
+}
+
+static double RelativeError(uint32_t i, const double* expected, float dt)
+{
+    double ex = vel_x[i] / dt - expected[0];
+    double ey = vel_y[i] / dt - expected[1];
+    double ez = vel_z[i] / dt - expected[2];
+    double norm = sqrt(expected[0] * expected[0] + expected[1] * expected[1] + expected[2] * expected[2]);
+
+    return sqrt(ex * ex + ey * ey + ez * ez) / norm;
+}
+
+// Cada cuerpo de una hoja compartida excluye su propia masa, no solo el primero.
+// Los dos de la hoja ven al resto uno a uno: su aceleración es la exacta. Los
+// demás ven a la pareja en su centro de masas.
+static void TestSharedLeaf(void)
+{
+    NBodySet set = { pos_x, pos_y, pos_z, vel_x, vel_y, vel_z, mass, BODIES, 1.0f, 0.05f, 0.0f };
+    double expected[BODIES][3];
+    float dt = 1e-3f;
+    uint32_t errors = 0;
+
+    Setup();
+    for (uint32_t i = 0; i < BODIES; i++) {
+        DirectAcceleration(&set, i, expected[i]);
+    }
+
+    // Parten del reposo: tras un paso la velocidad es a·dt
+    NBody_Step(&set, dt);
+    CHECK(NBody_UsedTree());
+
+    CHECK(RelativeError(PARTNER, expected[PARTNER], dt) < 1e-4);
+    CHECK(RelativeError(SHARED, expected[SHARED], dt) < 1e-4);
+
+    for (uint32_t i = 0; i < BODIES; i++) {
+        if (RelativeError(i, expected[i], dt) > 0.02) errors++;
+    }
+    CHECK_EQ(errors, 0);
+}
+
+int main(void)
+{
+    TestSharedLeaf();
+
+    TEST_END();
+}
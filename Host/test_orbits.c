@@ -0,0 +1,242 @@
+#include "host_test.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include "../Graphics/compositor.h"
+#include "../Graphics/dirty_rect.h"
+#include "../SolarSystem/solar_system.h"
+#include <math.h>
+#include <stdlib.h>
+
+// Capa de órbitas con SOLAR_ORBITS_ENABLE = 1 (Makefile). Sol y planetas de un
+// píxel de radio: lo que marcan los cuerpos es poco y la caja de una órbita se nota.
+
+// Fuera del rango de cualquier vértice (±4096): solo lo deja un frame sin reconstrucción
+#define POKED  5000
+
+static SolarSystem sys;
+static Camera cam;
+static uint16_t screen[LCD_HEIGHT][LCD_WIDTH];
+
+static void Setup(void)
+{
+    CelestialBody body;
+
+    SolarSystem_Init(&sys);
+    sys.body_count = 0;
+
+    CelestialBody_Init(&body, "Sun", BODY_TYPE_SUN);
+    CelestialBody_SetVisuals(&body, 1.0f, COLOR_YELLOW);
+    SolarSystem_AddBody(&sys, &body, BODY_NONE);
+
+    CelestialBody_Init(&body, "Inner", BODY_TYPE_PLANET);
+    CelestialBody_SetVisuals(&body, 1.0f, COLOR_RED);
+    CelestialBody_SetOrbitalParams(&body, 60.0f, 0.3f, 0.2f);
+    SolarSystem_AddBody(&sys, &body, 0);
+
+    CelestialBody_Init(&body, "Outer", BODY_TYPE_PLANET);
+    CelestialBody_SetVisuals(&body, 1.0f, COLOR_BLUE);
+    CelestialBody_SetOrbitalParams(&body, 170.0f, 0.2f, 0.05f);
+    SolarSystem_AddBody(&sys, &body, 0);
+
+    // Las lunas no dibujan órbita
+    CelestialBody_Init(&body, "Moon", BODY_TYPE_MOON);
+    CelestialBody_SetVisuals(&body, 1.0f, COLOR_WHITE);
+    CelestialBody_SetOrbitalParams(&body, 12.0f, 1.0f, 0.0f);
+    SolarSystem_AddBody(&sys, &body, 2);
+
+    SolarSystem_Update(&sys, 0.5f);
+
+    Camera_Init(&cam, 60.0f, (float)LCD_WIDTH / LCD_HEIGHT);
+    Camera_SetOrbit(&cam, 0.3f, 200.0f, 100.0f);
+    Camera_Update(&cam, 0.01f);
+
+    LCD_SetScrollArea(0, 0);
+    LCD_SetScroll(0);
+    Compositor_Init(COLOR_SPACE);
+    Compositor_AddLayer(SolarSystem_OrbitsLayer, &sys);
+    Compositor_AddLayer(SolarSystem_BodiesLayer, &sys);
+}
+
+// Como Game_Render: proyección y regiones dañadas, sin enviar todavía
+static void PrepareFrame(void)
+{
+    Compositor_BeginFrame();
+    SolarSystem_PrepareFrame(&sys, &cam, 0.0f);
+    SolarSystem_MarkDirty(&sys);
+}
+
+static uint32_t DirtyArea(void)
+{
+    uint32_t area = 0;
+
+    for (uint8_t i = 0; i < Dirty_GetCount(); i++) {
+        const DirtyRect* r = Dirty_GetRect(i);
+        area += (uint32_t)(r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1);
+    }
+    return area;
+}
+
+// Lo enviado por regiones tiene que ser igual a recomponer toda la pantalla
+static uint32_t DiffersFromFullRedraw(void)
+{
+    uint32_t errors = 0;
+
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            screen[y][x] = LCDFB_GetPixel(x, y);
+        }
+    }
+
+    Compositor_Invalidate(0, 0, LCD_WIDTH, LCD_HEIGHT);
+    Dirty_AddAll();
+    Dirty_Compose();
+
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            if (LCDFB_GetPixel(x, y) != screen[y][x]) errors++;
+        }
+    }
+    return errors;
+}
+
+// Los vértices de la recurrencia frente a un cosf/sinf por vértice: como mucho un
+// píxel de diferencia por el truncado a entero
+static void TestVertices(void)
+{
+    Setup();
+    LCD_Clear(COLOR_SPACE);
+    PrepareFrame();
+    Dirty_AddAll();
+    Dirty_Compose();
+
+    uint32_t far = 0;
+    uint32_t shown = 0;
+    uint32_t on_screen = 0;
+
+    for (BodyHandle h = 1; h <= 2; h++) {
+        const OrbitCache* cache = &sys.orbit_cache[h];
+
+        CHECK(cache->valid);
+
+        for (uint16_t j = 0; j < ORBIT_POINTS; j++) {
+            float a = TWO_PI * j / ORBIT_POINTS;
+            float r = sys.orbit_radius[h];
+            Vector3 p = vec3_create(r * cosf(a), r * sys.orbit_tilt_sin[h] * sinf(a), r * sinf(a));
+            Vector2 s = Camera_WorldToScreen(&cam, p, LCD_WIDTH, LCD_HEIGHT);
+
+            if (abs(cache->x[j] - (int16_t)s.x) > 1 || abs(cache->y[j] - (int16_t)s.y) > 1) far++;
+
+            if (cache->x[j] >= 0 && cache->x[j] < LCD_WIDTH && cache->y[j] >= 0 && cache->y[j] < LCD_HEIGHT) {
+                on_screen++;
+                if (LCDFB_GetPixel(cache->x[j], cache->y[j]) == ORBIT_COLOR) shown++;
+            }
+        }
+    }
+
+    CHECK_EQ(far, 0);
+    CHECK(!sys.orbit_cache[3].valid);
+
+    // En el panel cada vértice es de la órbita salvo el que tapa su planeta
+    CHECK(on_screen > ORBIT_POINTS);
+    CHECK(shown + 2 >= on_screen);
+}
+
+// Con la cámara y el centro quietos la órbita no se reconstruye ni marca nada;
+// al moverse se marcan la caja vieja y la nueva y el panel queda como recompuesto
+static void TestCacheHit(void)
+{
+    Setup();
+    LCD_Clear(COLOR_SPACE);
+    PrepareFrame();
+    Dirty_AddAll();
+    Dirty_Compose();
+
+    OrbitCache* cache = &sys.orbit_cache[2];
+    int16_t vertex = cache->x[5];
+
+    // Un vértice tocado a mano sobrevive a un frame sin cambios: no hubo reconstrucción
+    cache->x[5] = POKED;
+    PrepareFrame();
+    CHECK_EQ(cache->x[5], POKED);
+    CHECK(DirtyArea() < 100);
+    Dirty_Compose();
+    cache->x[5] = vertex;
+
+    // La cámara cambia de versión: se reconstruyen las dos órbitas
+    uint32_t box = (uint32_t)(cache->x1 - cache->x0 + 1) * (cache->y1 - cache->y0 + 1);
+    Camera_SetOrbit(&cam, 0.35f, 190.0f, 105.0f);
+    Camera_Update(&cam, 0.01f);
+
+    cache->x[5] = POKED;
+    PrepareFrame();
+    CHECK(cache->x[5] != POKED);
+    CHECK(DirtyArea() >= box);
+    Dirty_Compose();
+    CHECK_EQ(DiffersFromFullRedraw(), 0);
+
+    // El centro se mueve: solo cambia lo de los planetas de ese padre
+    sys.pos_x[0] += 4.0f;
+    cache->x[5] = POKED;
+    PrepareFrame();
+    CHECK(cache->x[5] != POKED);
+    Dirty_Compose();
+    CHECK_EQ(DiffersFromFullRedraw(), 0);
+}
+
+// Scroll del fondo como en Game_ScrollStars: la copia desplazada se borra, la parte
+// que da la vuelta también, y la órbita vuelve a su sitio
+static void TestScroll(void)
+{
+    uint16_t scroll = 0;
+    uint32_t errors = 0;
+
+    Setup();
+
+    // Con el sol desplazado la órbita exterior sale por la izquierda y no llega a la
+    // derecha: lo que da la vuelta no lo cubre su caja
+    sys.pos_x[0] = -70.0f;
+    sys.pos_z[0] = 70.0f;
+
+    LCD_Clear(COLOR_SPACE);
+    PrepareFrame();
+    Dirty_AddAll();
+    Dirty_Compose();
+    CHECK(sys.orbit_cache[2].x0 < 0 && sys.orbit_cache[2].x1 < LCD_WIDTH - 20);
+
+    for (uint8_t frame = 0; frame < 20; frame++) {
+        uint16_t steps = 1 + frame % 4;
+
+        scroll = (scroll + steps) % LCD_WIDTH;
+        LCD_SetScroll(scroll);
+        Compositor_Invalidate(0, 0, LCD_WIDTH, LCD_HEIGHT);
+
+        // Un frame de cada cinco la cámara también se mueve
+        if (frame % 5 == 4) {
+            Camera_SetOrbit(&cam, 0.3f + 0.01f * frame, 200.0f, 100.0f);
+            Camera_Update(&cam, 0.01f);
+        }
+
+        Compositor_BeginFrame();
+        SolarSystem_PrepareFrame(&sys, &cam, 0.0f);
+        SolarSystem_ScrollScreen(&sys, steps);
+        SolarSystem_MarkDirty(&sys);
+        Dirty_Compose();
+
+        errors += DiffersFromFullRedraw();
+    }
+
+    CHECK_EQ(errors, 0);
+    LCD_SetScroll(0);
+}
+
+int main(void)
+{
+    LCD_SetDevice(&lcd_trace_device);
+    LCDTrace_Attach(&lcd_fb_device);
+    LCD_Init();
+
+    TestVertices();
+    TestCacheHit();
+    TestScroll();
+
+    TEST_END();
+}
@@ -0,0 +1,218 @@
+#include "host_test.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include "../Graphics/compositor.h"
+#include "../Graphics/dirty_rect.h"
+#include "../Graphics/renderer.h"
+
+// Scroll por hardware sobre el framebuffer, que interpreta VSCRDEF/VSCRSADD como el
+// ILI9341: las primitivas reciben columnas de pantalla y LCDFB_GetPixel devuelve lo
+// que se ve, con el desplazamiento aplicado.
+
+static uint16_t screen[LCD_HEIGHT][LCD_WIDTH];
+
+static void Snapshot(void)
+{
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            screen[y][x] = LCDFB_GetPixel(x, y);
+        }
+    }
+}
+
+static uint32_t CountDifferences(void)
+{
+    uint32_t errors = 0;
+
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            if (LCDFB_GetPixel(x, y) != screen[y][x]) errors++;
+        }
+    }
+    return errors;
+}
+
+// Lo ya enviado se desplaza con un solo comando y da la vuelta por la derecha
+static void TestContentMoves(void)
+{
+    LCD_SetScrollArea(0, 0);
+    LCD_Clear(COLOR_BLACK);
+    LCD_FillRect(2, 10, 4, 4, COLOR_RED);
+    LCD_FillRect(100, 50, 10, 10, COLOR_GREEN);
+
+    LCD_ResetBusStats();
+    LCD_SetScroll(5);
+
+    CHECK_EQ(LCD_GetBusStats()->commands, 1);
+    CHECK_EQ(LCD_GetBusStats()->bytes, 3);
+    CHECK_EQ(LCD_GetScroll(), 5);
+    CHECK_EQ(LCDFB_GetPixel(95, 50), COLOR_GREEN);
+    CHECK_EQ(LCDFB_GetPixel(104, 59), COLOR_GREEN);
+    CHECK_EQ(LCDFB_GetPixel(105, 50), COLOR_BLACK);
+    CHECK_EQ(LCDFB_GetPixel(LCD_WIDTH - 3, 10), COLOR_RED);
+    CHECK_EQ(LCDFB_GetPixel(0, 10), COLOR_RED);
+    CHECK_EQ(LCDFB_GetPixel(1, 10), COLOR_BLACK);
+
+    LCD_SetScroll(LCD_WIDTH);
+    CHECK_EQ(LCD_GetScroll(), 0);
+    CHECK_EQ(LCDFB_GetPixel(100, 50), COLOR_GREEN);
+}
+
+// Con scroll las primitivas dibujan en columnas de pantalla, también cuando la
+// ventana cruza el punto de vuelta de la RAM
+static void TestPrimitivesFollowScroll(void)
+{
+    uint16_t bitmap[40 * 3];
+
+    for (uint16_t i = 0; i < 40 * 3; i++) {
+        bitmap[i] = 0x0100 + i;
+    }
+
+    for (uint16_t offset = 0; offset < LCD_WIDTH; offset += 37) {
+        LCD_SetScroll(0);
+        LCD_Clear(COLOR_BLACK);
+        LCD_SetScroll(offset);
+
+        LCD_FillRect(280, 20, 40, 5, COLOR_BLUE);
+        LCD_DrawBitmap(270, 40, 40, 3, bitmap);
+        LCD_DrawPixel(319, 60, COLOR_YELLOW);
+        LCD_DrawHLine(0, 70, LCD_WIDTH, COLOR_WHITE);
+
+        uint32_t errors = 0;
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            uint16_t rect = (x >= 280) ? COLOR_BLUE : COLOR_BLACK;
+            if (LCDFB_GetPixel(x, 20) != rect || LCDFB_GetPixel(x, 24) != rect) errors++;
+            if (LCDFB_GetPixel(x, 70) != COLOR_WHITE) errors++;
+
+            for (int16_t row = 0; row < 3; row++) {
+                uint16_t want = (x >= 270 && x < 310) ? bitmap[row * 40 + x - 270] : COLOR_BLACK;
+                if (LCDFB_GetPixel(x, 40 + row) != want) errors++;
+            }
+        }
+        CHECK_EQ(errors, 0);
+        CHECK_EQ(LCDFB_GetPixel(319, 60), COLOR_YELLOW);
+        CHECK_EQ(LCDFB_GetPixel(318, 60), COLOR_BLACK);
+    }
+
+    LCD_SetScroll(0);
+}
+
+// Franjas fijas a izquierda y derecha: solo se mueve lo que queda entre ellas
+static void TestFixedAreas(void)
+{
+    LCD_SetScrollArea(20, 30);
+    LCD_Clear(COLOR_BLACK);
+    LCD_FillRect(10, 0, 1, 1, COLOR_RED);
+    LCD_FillRect(300, 0, 1, 1, COLOR_GREEN);
+    LCD_FillRect(25, 0, 1, 1, COLOR_BLUE);
+
+    LCD_SetScroll(3);
+
+    CHECK_EQ(LCDFB_GetPixel(10, 0), COLOR_RED);
+    CHECK_EQ(LCDFB_GetPixel(300, 0), COLOR_GREEN);
+    CHECK_EQ(LCDFB_GetPixel(22, 0), COLOR_BLUE);
+    CHECK_EQ(LCDFB_GetPixel(25, 0), COLOR_BLACK);
+
+    // Dentro del área de scroll la vuelta se da en su borde, no en el de la pantalla
+    LCD_FillRect(285, 5, 10, 1, COLOR_CYAN);
+    uint32_t errors = 0;
+    for (int16_t x = 0; x < LCD_WIDTH; x++) {
+        uint16_t want = (x >= 285 && x < 295) ? COLOR_CYAN : COLOR_BLACK;
+        if (LCDFB_GetPixel(x, 5) != want) errors++;
+    }
+    CHECK_EQ(errors, 0);
+
+    LCD_SetScrollArea(0, 0);
+}
+
+// Escena como la del firmware: estrellas que solo se desplazan, una caja fija en
+// pantalla y la barra de UI. Cada paso recompone solo la caja, la copia desplazada
+// y la barra; el resultado tiene que ser igual a recomponer todo. La caja empieza
+// en un tramo de 16 columnas, así que la copia desplazada cae en el tramo anterior.
+#define BOX_X  160
+#define BOX_Y  100
+#define BOX_W  24
+#define BAR_H  30
+#define BAR_ITEMS_W  60
+
+static void BoxLayer(void* ctx, CompositorTile* tile)
+{
+    Compositor_FillRect(tile, BOX_X, BOX_Y, BOX_W, BOX_W, COLOR_ORANGE);
+}
+
+static void BarLayer(void* ctx, CompositorTile* tile)
+{
+    if (tile->y >= BAR_H) return;
+
+    Compositor_FillRect(tile, 0, 0, LCD_WIDTH, BAR_H, COLOR_BLACK);
+    Compositor_FillRect(tile, 5, 5, BAR_ITEMS_W - 5, 20, COLOR_MAGENTA);
+}
+
+static void ComposeAll(void)
+{
+    Compositor_Invalidate(0, 0, LCD_WIDTH, LCD_HEIGHT);
+    Dirty_AddAll();
+    Dirty_Compose();
+}
+
+static void TestSceneMatchesFullRedraw(void)
+{
+    uint16_t scroll = 0;
+    uint32_t errors = 0;
+    uint32_t step_bytes = 0;
+    uint32_t full_bytes;
+
+    LCD_SetScrollArea(0, 0);
+    Renderer_Init();
+    Renderer_SetupStars(12345, 80);
+    Compositor_Init(COLOR_SPACE);
+    Compositor_AddLayer(Renderer_StarsLayer, NULL);
+    Compositor_AddLayer(BoxLayer, NULL);
+    Compositor_AddLayer(BarLayer, NULL);
+
+    LCD_ResetBusStats();
+    ComposeAll();
+    full_bytes = LCD_GetBusStats()->bytes;
+
+    for (uint8_t frame = 0; frame < 60; frame++) {
+        uint16_t steps = 1 + frame % 4;
+
+        LCD_ResetBusStats();
+
+        scroll = (scroll + steps) % LCD_WIDTH;
+        LCD_SetScroll(scroll);
+        Renderer_SetStarDrift(scroll);
+        Compositor_Invalidate(0, 0, LCD_WIDTH, LCD_HEIGHT);
+
+        // La caja enviada se ve steps columnas a la izquierda
+        Dirty_Add(BOX_X - steps, BOX_Y, BOX_W + steps, BOX_W);
+        Dirty_Add(0, 0, BAR_ITEMS_W, BAR_H);
+        Dirty_Compose();
+
+        step_bytes += LCD_GetBusStats()->bytes;
+
+        Snapshot();
+        ComposeAll();
+        errors += CountDifferences();
+    }
+
+    CHECK_EQ(errors, 0);
+
+    // Un paso cuesta la caja y la barra, no la pantalla
+    CHECK(step_bytes / 60 < full_bytes / 10);
+
+    LCD_SetScroll(0);
+}
+
+int main(void)
+{
+    LCD_SetDevice(&lcd_trace_device);
+    LCDTrace_Attach(&lcd_fb_device);
+    LCD_Init();
+
+    TestContentMoves();
+    TestPrimitivesFollowScroll();
+    TestFixedAreas();
+    TestSceneMatchesFullRedraw();
+
+    TEST_END();
+}
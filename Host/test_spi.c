@@ -0,0 +1,202 @@
+#include "host_test.h"
+#include "spi_host.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include "../Drivers/LCD/lcd_queue.h"
+
+// lcd_device_spi.c sobre el doble de SPI1: lo que sale por MOSI se decodifica como
+// lo haría el ILI9341 (comandos con D/C bajo, CASET/PASET/RAMWR y píxeles de 16 bits)
+// y se compara con lo dibujado. La cola se vacía desde un PendSV simulado que solo
+// avanza con los fines de DMA.
+
+static uint16_t panel[LCD_HEIGHT][LCD_WIDTH];
+static uint16_t image[LCD_HEIGHT][LCD_WIDTH];
+
+static uint8_t command;
+static uint8_t params[4];
+static uint8_t param_count;
+static uint16_t x0, x1, y0, y1, px, py;
+static uint8_t first_command;
+static uint8_t first_params;
+static uint32_t commands;
+static uint32_t stray_pixels;    // Píxeles fuera de RAMWR
+
+static void Decode(uint8_t dc, uint8_t bits, uint16_t value)
+{
+    if (!dc) {
+        if (commands == 0) first_command = value;
+        commands++;
+        command = value;
+        param_count = 0;
+        if (command == LCD_CMD_RAMWR) {
+            px = x0;
+            py = y0;
+        }
+        return;
+    }
+
+    if (bits == 8) {
+        if (commands == 1) first_params++;
+        if (param_count < 4) params[param_count] = value;
+        param_count++;
+
+        if (param_count == 4 && command == LCD_CMD_CASET) {
+            x0 = (params[0] << 8) | params[1];
+            x1 = (params[2] << 8) | params[3];
+        } else if (param_count == 4 && command == LCD_CMD_PASET) {
+            y0 = (params[0] << 8) | params[1];
+            y1 = (params[2] << 8) | params[3];
+        }
+        return;
+    }
+
+    if (command != LCD_CMD_RAMWR) {
+        stray_pixels++;
+        return;
+    }
+
+    if (py < LCD_HEIGHT && px < LCD_WIDTH) panel[py][px] = value;
+    if (px++ == x1) {
+        px = x0;
+        if (py++ == y1) py = y0;
+    }
+}
+
+// PendSV: desde otra interrupción queda pendiente y entra al volver al bucle principal
+static uint8_t pendsv_pending;
+
+void Host_PendSV(void)
+{
+    if (host_ipsr != 0) {
+        pendsv_pending = 1;
+        return;
+    }
+
+    do {
+        pendsv_pending = 0;
+        host_ipsr = HOST_IPSR_PENDSV;
+        LCDQueue_Service();
+        host_ipsr = 0;
+    } while (pendsv_pending);
+}
+
+// Fin de la ráfaga en curso y lo que encadena al volver
+static uint8_t DmaInterrupt(void)
+{
+    uint8_t done = HostSpi_CompleteDMA();
+
+    if (pendsv_pending) Host_PendSV();
+    return done;
+}
+
+static uint32_t CountDifferences(uint16_t color, const uint16_t* pixels)
+{
+    uint32_t errors = 0;
+
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            uint16_t want = pixels ? pixels[y * LCD_WIDTH + x] : color;
+            if (panel[y][x] != want) errors++;
+        }
+    }
+    return errors;
+}
+
+static void CheckClean(void)
+{
+    const HostSpiStats* spi = HostSpi_GetStats();
+
+    CHECK_EQ(spi->cs_errors, 0);
+    CHECK_EQ(spi->overlap_errors, 0);
+    CHECK_EQ(spi->handler_waits, 0);
+    CHECK_EQ(spi->asserts, 0);
+    CHECK_EQ(stray_pixels, 0);
+}
+
+// Secuencia de arranque en tramas de 8 bits; los bytes del bus son los que cuenta el driver
+static void TestInitStream(void)
+{
+    LCD_ResetBusStats();
+    LCD_Init();
+
+    CHECK_EQ(first_command, 0xCB);
+    CHECK_EQ(first_params, 5);
+    CHECK_EQ(commands, LCD_GetBusStats()->commands);
+    CHECK_EQ(HostSpi_GetStats()->bytes, LCD_GetBusStats()->bytes);
+    CheckClean();
+}
+
+// Dibujo directo desde el bucle principal: las ráfagas largas se parten y se
+// esperan aquí, y las cortas van por DR
+static void TestDirect(void)
+{
+    uint32_t transfers = HostSpi_GetStats()->dma_transfers;
+
+    LCD_Clear(COLOR_BLUE);
+    LCD_EndPixels();
+    CHECK_EQ(CountDifferences(COLOR_BLUE, 0), 0);
+    CHECK_EQ(HostSpi_GetStats()->dma_transfers - transfers, 2);
+
+    LCD_FillRect(10, 20, 4, 3, COLOR_RED);
+    LCD_DrawPixel(100, 100, COLOR_GREEN);
+    LCD_DrawPixel(101, 100, COLOR_YELLOW);
+
+    CHECK_EQ(panel[20][10], COLOR_RED);
+    CHECK_EQ(panel[22][13], COLOR_RED);
+    CHECK_EQ(panel[23][13], COLOR_BLUE);
+    CHECK_EQ(panel[100][100], COLOR_GREEN);
+    CHECK_EQ(panel[100][101], COLOR_YELLOW);
+    CheckClean();
+}
+
+// Una pantalla entera desde la cola: más de lo que cuenta NDTR. PendSV envía un
+// tramo por fin de DMA y nunca espera dentro de la interrupción.
+static void TestQueuedLongBursts(void)
+{
+    for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+        for (int16_t x = 0; x < LCD_WIDTH; x++) {
+            image[y][x] = (uint16_t)(x * 7 + y * 311);
+        }
+    }
+
+    uint32_t transfers = HostSpi_GetStats()->dma_transfers;
+    uint32_t interrupts = 0;
+
+    LCDQueue_Window(0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1);
+    LCDQueue_Pixels(&image[0][0], (uint32_t)LCD_WIDTH * LCD_HEIGHT);
+    LCDQueue_End();
+    LCDQueue_Window(0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1);
+    LCDQueue_Color(COLOR_CYAN, (uint32_t)LCD_WIDTH * LCD_HEIGHT);
+    LCDQueue_End();
+    uint32_t fence = LCDQueue_Fence();
+
+    // Solo el primer tramo salió; el resto espera a su interrupción
+    CHECK_EQ(HostSpi_GetStats()->dma_transfers - transfers, 1);
+    CHECK(!LCDQueue_FenceDone(fence));
+
+    while (!LCDQueue_FenceDone(fence) && interrupts < 16) {
+        interrupts += DmaInterrupt();
+
+        // Tras la primera pantalla y antes de la segunda ventana
+        if (HostSpi_GetStats()->dma_transfers - transfers == 2) {
+            CHECK_EQ(CountDifferences(0, &image[0][0]), 0);
+        }
+    }
+
+    CHECK(LCDQueue_FenceDone(fence));
+    CHECK_EQ(HostSpi_GetStats()->dma_transfers - transfers, 4);
+    CHECK_EQ(CountDifferences(COLOR_CYAN, 0), 0);
+    CheckClean();
+}
+
+int main(void)
+{
+    HostSpi_Init(Decode);
+    LCD_SetDevice(&lcd_spi_device);
+    LCDQueue_Init();
+
+    TestInitStream();
+    TestDirect();
+    TestQueuedLongBursts();
+
+    TEST_END();
+}
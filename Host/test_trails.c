@@ -0,0 +1,174 @@
+#include "host_test.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include "../Graphics/compositor.h"
+#include "../Graphics/dirty_rect.h"
+#include "../SolarSystem/solar_system.h"
+#include <math.h>
+
+// Estelas con SOLAR_TRAILS_ENABLE = 1, con la longitud por defecto y con otra que
+// no es múltiplo de los tonos (Makefile). La prueba sustituye a dirty_rect.c: cada
+// Dirty_Add queda registrado tal cual, sin uniones.
+
+#define MAX_ADDS  16
+#define FRAMES    (3 * TRAIL_LENGTH + 10)
+
+// Frames en que el cuerpo sale de pantalla: cortan la estela
+#define GAP_FIRST  (TRAIL_LENGTH + 3)
+#define GAP_LAST   (TRAIL_LENGTH + 5)
+
+static DirtyRect adds[MAX_ADDS];
+static uint8_t add_count;
+
+void Dirty_Add(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    if (add_count < MAX_ADDS) {
+        adds[add_count].x0 = x;
+        adds[add_count].y0 = y;
+        adds[add_count].x1 = x + w - 1;
+        adds[add_count].y1 = y + h - 1;
+    }
+    add_count++;
+}
+
+static SolarSystem sys;
+static uint16_t before[LCD_WIDTH * LCD_HEIGHT];
+static uint16_t after[LCD_WIDTH * LCD_HEIGHT];
+
+static uint8_t Visible(int16_t frame)
+{
+    return frame < GAP_FIRST || frame > GAP_LAST;
+}
+
+// Recorrido con pasos de varios píxeles en los dos ejes
+static int16_t PathX(int16_t frame)
+{
+    return 160 + (int16_t)(120.0f * cosf(frame * 0.09f));
+}
+
+static int16_t PathY(int16_t frame)
+{
+    return 120 + (int16_t)(90.0f * sinf(frame * 0.13f));
+}
+
+// Mismo tono que SolarSystem_TrailsLayer para el segmento que empieza en age
+static uint8_t Level(int16_t age)
+{
+    return age * TRAIL_FADE_LEVELS / TRAIL_LENGTH;
+}
+
+// Caja del segmento entre las posiciones de los frames a y b, si los dos existen
+static uint8_t SegmentBox(int16_t a, int16_t b, DirtyRect* box)
+{
+    if (a < 0 || b < 0 || !Visible(a) || !Visible(b)) return 0;
+
+    box->x0 = (PathX(a) < PathX(b)) ? PathX(a) : PathX(b);
+    box->x1 = (PathX(a) < PathX(b)) ? PathX(b) : PathX(a);
+    box->y0 = (PathY(a) < PathY(b)) ? PathY(a) : PathY(b);
+    box->y1 = (PathY(a) < PathY(b)) ? PathY(b) : PathY(a);
+    return 1;
+}
+
+static uint8_t SameBox(const DirtyRect* a, const DirtyRect* b)
+{
+    return a->x0 == b->x0 && a->y0 == b->y0 && a->x1 == b->x1 && a->y1 == b->y1;
+}
+
+static void RenderTrails(uint16_t* pixels)
+{
+    CompositorTile tile = { pixels, 0, 0, LCD_WIDTH, LCD_HEIGHT };
+
+    for (uint32_t i = 0; i < LCD_WIDTH * LCD_HEIGHT; i++) {
+        pixels[i] = COLOR_SPACE;
+    }
+    SolarSystem_TrailsLayer(&sys, &tile);
+}
+
+// Cada frame marca el segmento nuevo, el que caduca y los que cambian de tono, y
+// nada más: el número de regiones no depende de TRAIL_LENGTH. Todo píxel de la
+// estela que cambia queda dentro de alguna.
+static void TestSegments(void)
+{
+    uint32_t missing = 0;
+    uint32_t extra = 0;
+    uint32_t uncovered = 0;
+    uint32_t most = 0;
+
+    SolarSystem_Init(&sys);
+    sys.info[0].color = COLOR_WHITE;
+    SolarSystem_SetTrail(&sys, 0, 1);
+    RenderTrails(before);
+
+    for (int16_t frame = 0; frame < FRAMES; frame++) {
+        sys.is_visible[0] = Visible(frame);
+        sys.screen_x[0] = PathX(frame);
+        sys.screen_y[0] = PathY(frame);
+        sys.screen_radius[0] = 2;
+
+        // Antes de la estela el cuerpo marca su disco anterior y el actual
+        uint8_t body_adds = (sys.prev_screen_radius[0] > 0) + sys.is_visible[0];
+
+        add_count = 0;
+        SolarSystem_MarkDirty(&sys);
+        CHECK(add_count <= MAX_ADDS);
+
+        // Segmentos esperados, por la edad del punto más reciente de cada uno
+        DirtyRect expected[2 + TRAIL_FADE_LEVELS];
+        uint8_t expected_count = 0;
+
+        if (SegmentBox(frame, frame - 1, &expected[expected_count])) expected_count++;
+        if (frame >= TRAIL_LENGTH &&
+            SegmentBox(frame - TRAIL_LENGTH + 1, frame - TRAIL_LENGTH, &expected[expected_count])) {
+            expected_count++;
+        }
+        for (int16_t age = 1; age < TRAIL_LENGTH - 1; age++) {
+            if (Level(age) != Level(age - 1) &&
+                SegmentBox(frame - age, frame - age - 1, &expected[expected_count])) {
+                expected_count++;
+            }
+        }
+
+        uint8_t trail_adds = add_count - body_adds;
+        if (trail_adds > most) most = trail_adds;
+
+        for (uint8_t e = 0; e < expected_count; e++) {
+            uint8_t found = 0;
+            for (uint8_t i = body_adds; i < add_count; i++) {
+                found |= SameBox(&adds[i], &expected[e]);
+            }
+            if (!found) missing++;
+        }
+        if (trail_adds != expected_count) extra++;
+
+        RenderTrails(after);
+        for (int16_t y = 0; y < LCD_HEIGHT; y++) {
+            for (int16_t x = 0; x < LCD_WIDTH; x++) {
+                if (before[y * LCD_WIDTH + x] == after[y * LCD_WIDTH + x]) continue;
+
+                uint8_t inside = 0;
+                for (uint8_t i = 0; i < add_count && !inside; i++) {
+                    inside = x >= adds[i].x0 && x <= adds[i].x1 && y >= adds[i].y0 && y <= adds[i].y1;
+                }
+                if (!inside) uncovered++;
+            }
+        }
+
+        for (uint32_t i = 0; i < LCD_WIDTH * LCD_HEIGHT; i++) {
+            before[i] = after[i];
+        }
+    }
+
+    CHECK_EQ(missing, 0);
+    CHECK_EQ(extra, 0);
+    CHECK_EQ(uncovered, 0);
+
+    // Cabeza, cola y un cambio de tono por nivel
+    CHECK(most <= 1 + TRAIL_FADE_LEVELS);
+}
+
+int main(void)
+{
+    TestSegments();
+
+    printf("TRAIL_LENGTH = %d: ", TRAIL_LENGTH);
+    TEST_END();
+}
@@ -22,6 +22,8 @@ void Camera_Init(Camera* cam, float fov, float aspect)
     cam->warp_progress = 0.0f;
     cam->warp_duration = 1.0f;
 
+    cam->version = 0;
+    cam->dirty = CAMERA_DIRTY_ORBIT | CAMERA_DIRTY_VIEW | CAMERA_DIRTY_PROJECTION;
     Camera_UpdateMatrices(cam);
 }
 
@@ -44,28 +46,97 @@ void Camera_Update(Camera* cam, float deltaTime)
             cam->position.y = lerp(cam->warp_start_pos.y, cam->warp_target_pos.y, t);
             cam->position.z = lerp(cam->warp_start_pos.z, cam->warp_target_pos.z, t);
         }
-    } else {
-        // Actualizar posición basada en ángulo y distancia
+
+        cam->dirty |= CAMERA_DIRTY_VIEW;
+    } else if (cam->dirty & CAMERA_DIRTY_ORBIT) {
+        // Actualizar posición basada en ángulo y distancia. Tras un warp la cámara
+        // se queda donde llegó hasta que cambie la órbita.
         cam->position.x = cam->distance * fast_cos(cam->angle);
         cam->position.z = cam->distance * fast_sin(cam->angle);
         cam->position.y = cam->height;
+
+        cam->dirty = (cam->dirty & ~CAMERA_DIRTY_ORBIT) | CAMERA_DIRTY_VIEW;
     }
 
     // Actualizar matrices
     Camera_UpdateMatrices(cam);
 }
 
+// Planos a partir de las columnas de view_projection (clip = v * M): cada plano es
+// w ± x, w ± y o w ± z >= 0
+static void Camera_UpdateFrustum(Camera* cam)
+{
+    const Matrix4x4* m = &cam->view_projection;
+
+    for (uint8_t p = 0; p < 6; p++) {
+        uint8_t axis = p >> 1;
+        float sign = (p & 1) ? -1.0f : 1.0f;
+        float* plane = cam->frustum[p];
+
+        for (uint8_t row = 0; row < 4; row++) {
+            plane[row] = m->m[row][3] + sign * m->m[row][axis];
+        }
+
+        float len = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (len > 0.0f) {
+            for (uint8_t k = 0; k < 4; k++) {
+                plane[k] /= len;
+            }
+        }
+    }
+}
+
 void Camera_UpdateMatrices(Camera* cam)
 {
+    if (!(cam->dirty & (CAMERA_DIRTY_VIEW | CAMERA_DIRTY_PROJECTION))) return;
+
     // Matriz de vista
-    cam->view_matrix = mat4_look_at(cam->position, cam->target, cam->up);
+    if (cam->dirty & CAMERA_DIRTY_VIEW) {
+        cam->view_matrix = mat4_look_at(cam->position, cam->target, cam->up);
+    }
 
     // Matriz de proyección
-    cam->projection_matrix = mat4_perspective(cam->fov, cam->aspect,
-                                              cam->near_plane, cam->far_plane);
+    if (cam->dirty & CAMERA_DIRTY_PROJECTION) {
+        cam->projection_matrix = mat4_perspective(cam->fov, cam->aspect,
+                                                  cam->near_plane, cam->far_plane);
+    }
+
+    // Combinar ambas matrices: con vectores fila primero la vista y luego la proyección
+    cam->view_projection = mat4_multiply(cam->view_matrix, cam->projection_matrix);
+
+    Camera_UpdateFrustum(cam);
+
+    cam->dirty &= ~(CAMERA_DIRTY_VIEW | CAMERA_DIRTY_PROJECTION);
+    cam->version++;
+}
+
+void Camera_SetOrbit(Camera* cam, float angle, float distance, float height)
+{
+    if (angle == cam->angle && distance == cam->distance && height == cam->height) return;
+
+    cam->angle = angle;
+    cam->distance = distance;
+    cam->height = height;
+    cam->dirty |= CAMERA_DIRTY_ORBIT;
+}
+
+void Camera_SetTarget(Camera* cam, Vector3 target)
+{
+    if (target.x == cam->target.x && target.y == cam->target.y && target.z == cam->target.z) return;
 
-    // Combinar ambas matrices
-    cam->view_projection = mat4_multiply(cam->projection_matrix, cam->view_matrix);
+    cam->target = target;
+    cam->dirty |= CAMERA_DIRTY_VIEW;
+}
+
+void Camera_SetLens(Camera* cam, float fov, float aspect)
+{
+    float fov_rad = DEG_TO_RAD(fov);
+
+    if (fov_rad == cam->fov && aspect == cam->aspect) return;
+
+    cam->fov = fov_rad;
+    cam->aspect = aspect;
+    cam->dirty |= CAMERA_DIRTY_PROJECTION;
 }
 
 void Camera_Rotate(Camera* cam, float delta_angle)
@@ -74,6 +145,7 @@ void Camera_Rotate(Camera* cam, float delta_angle)
         cam->angle += delta_angle;
         if (cam->angle > TWO_PI) cam->angle -= TWO_PI;
         if (cam->angle < 0) cam->angle += TWO_PI;
+        cam->dirty |= CAMERA_DIRTY_ORBIT;
     }
 }
 
@@ -82,6 +154,7 @@ void Camera_Zoom(Camera* cam, float delta_distance)
     if (!cam->is_warping) {
         cam->distance += delta_distance;
         cam->distance = clamp(cam->distance, 20.0f, 500.0f);
+        cam->dirty |= CAMERA_DIRTY_ORBIT;
     }
 }
 
@@ -90,6 +163,7 @@ void Camera_MoveVertical(Camera* cam, float delta)
     if (!cam->is_warping && cam->mode_3d) {
         cam->height += delta;
         cam->height = clamp(cam->height, -200.0f, 200.0f);
+        cam->dirty |= CAMERA_DIRTY_ORBIT;
     }
 }
 
@@ -107,39 +181,62 @@ void Camera_WarpTo(Camera* cam, Vector3 target, float duration)
     cam->warp_duration = duration;
 }
 
-void Camera_WarpToBody(Camera* cam, CelestialBody* body, float duration)
+void Camera_WarpToBody(Camera* cam, Vector3 body_position, float body_radius, float duration)
 {
     // Calcular posición de observación cerca del cuerpo
-    Vector3 offset = vec3_create(body->radius * 5.0f, body->radius * 3.0f, body->radius * 5.0f);
-    Vector3 target_pos = vec3_add(body->position, offset);
+    Vector3 offset = vec3_create(body_radius * 5.0f, body_radius * 3.0f, body_radius * 5.0f);
+    Vector3 target_pos = vec3_add(body_position, offset);
 
     Camera_WarpTo(cam, target_pos, duration);
 }
 
-// Proyección ortográfica con escala pequeña para que TODO quepa
 Vector2 Camera_WorldToScreen(Camera* cam, Vector3 world_pos, int screen_width, int screen_height)
 {
+    Vector3 ndc = mat4_multiply_vector(cam->view_projection, world_pos);
 
-
-    float scale = 0.28f;  // Escala pequeña para que TODO quepa
-
-    // Centrar perfectamente en pantalla
-    float center_x = screen_width / 2.0f;
-    float center_y = screen_height / 2.0f;
-
-
-    float screen_x = (world_pos.x * scale) + center_x;
-    float screen_y = (world_pos.z * scale) + center_y;
-
+    // NDC en [-1, 1] con y hacia arriba; la pantalla tiene y hacia abajo
     Vector2 result;
-    result.x = screen_x;
-    result.y = screen_y;
+    result.x = (ndc.x + 1.0f) * 0.5f * screen_width;
+    result.y = (1.0f - ndc.y) * 0.5f * screen_height;
 
     return result;
 }
 
 uint8_t Camera_IsPointVisible(Camera* cam, Vector3 world_pos)
 {
+    return Camera_IsSphereVisible(cam, world_pos, 0.0f);
+}
+
+uint8_t Camera_IsSphereVisible(Camera* cam, Vector3 center, float radius)
+{
+    for (uint8_t p = 0; p < 6; p++) {
+        const float* plane = cam->frustum[p];
+        float d = plane[0] * center.x + plane[1] * center.y + plane[2] * center.z + plane[3];
+
+        if (d < -radius) return 0;
+    }
+    return 1;
+}
+
+uint8_t Camera_ProjectSphere(Camera* cam, Vector3 center, float radius, int screen_width, int screen_height,
+                             Vector2* screen_pos, float* screen_radius)
+{
+    if (!Camera_IsSphereVisible(cam, center, radius)) return 0;
+
+    // Distancia a lo largo del eje de la cámara (la vista mira hacia -z)
+    Vector3 view = mat4_multiply_vector(cam->view_matrix, center);
+    float depth = -view.z;
+
+    // Con el centro detrás del plano cercano la perspectiva no da un disco
+    if (depth <= cam->near_plane) return 0;
+
+    Vector2 pos = Camera_WorldToScreen(cam, center, screen_width, screen_height);
+    float r = radius * cam->projection_matrix.m[1][1] / depth * 0.5f * screen_height;
+
+    if (pos.x + r < 0.0f || pos.x - r >= screen_width) return 0;
+    if (pos.y + r < 0.0f || pos.y - r >= screen_height) return 0;
 
+    *screen_pos = pos;
+    *screen_radius = r;
     return 1;
 }
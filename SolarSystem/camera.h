@@ -1,9 +1,14 @@
 #ifndef CAMERA_H
 #define CAMERA_H
 
-#include "math3d.h"
+#include "../Utils/math3d.h"
 #include "celestial_body.h"
 
+// Qué hay que recalcular en el próximo Camera_Update
+#define CAMERA_DIRTY_ORBIT       0x01    // Posición a partir de ángulo, distancia y altura
+#define CAMERA_DIRTY_VIEW        0x02
+#define CAMERA_DIRTY_PROJECTION  0x04
+
 typedef struct {
     Vector3 position;
     Vector3 target;
@@ -34,15 +39,31 @@ typedef struct {
     Matrix4x4 projection_matrix;
     Matrix4x4 view_projection;
 
+    // Planos del frustum (a, b, c, d) con la normal hacia dentro y normalizada:
+    // izquierda, derecha, abajo, arriba, cerca, lejos
+    float frustum[6][4];
+
+    // Entradas cambiadas desde la última reconstrucción, y un contador que sube cada
+    // vez que cambia view_projection: las cachés que dependen de la cámara guardan el
+    // valor con el que se calcularon y solo rehacen su trabajo si no coincide
+    uint8_t dirty;
+    uint32_t version;
+
 } Camera;
 
 // Funciones de inicialización
 void Camera_Init(Camera* cam, float fov, float aspect);
 
-// Funciones de actualización
+// Funciones de actualización: solo se recalcula lo marcado en dirty
 void Camera_Update(Camera* cam, float deltaTime);
 void Camera_UpdateMatrices(Camera* cam);
 
+// Cambiar los parámetros a través de estas funciones (no escribiendo los campos)
+// para que se marquen las matrices afectadas
+void Camera_SetOrbit(Camera* cam, float angle, float distance, float height);
+void Camera_SetTarget(Camera* cam, Vector3 target);
+void Camera_SetLens(Camera* cam, float fov, float aspect);
+
 
 void Camera_Rotate(Camera* cam, float delta_angle);
 void Camera_Zoom(Camera* cam, float delta_distance);
@@ -51,10 +72,16 @@ void Camera_SetMode3D(Camera* cam, uint8_t enable);
 
 // Sistema de warp
 void Camera_WarpTo(Camera* cam, Vector3 target, float duration);
-void Camera_WarpToBody(Camera* cam, CelestialBody* body, float duration);
+void Camera_WarpToBody(Camera* cam, Vector3 body_position, float body_radius, float duration);
 
-// Proyección
+// Proyección en perspectiva con view_projection (vectores fila: v * M)
 Vector2 Camera_WorldToScreen(Camera* cam, Vector3 world_pos, int screen_width, int screen_height);
 uint8_t Camera_IsPointVisible(Camera* cam, Vector3 world_pos);
+uint8_t Camera_IsSphereVisible(Camera* cam, Vector3 center, float radius);
+
+// Centro y radio en pantalla de una esfera; 0 si queda fuera del frustum o de la
+// pantalla, antes de calcular nada más
+uint8_t Camera_ProjectSphere(Camera* cam, Vector3 center, float radius, int screen_width, int screen_height,
+                             Vector2* screen_pos, float* screen_radius);
 
 #endif // CAMERA_H
@@ -1,7 +1,7 @@
 #ifndef CELESTIAL_BODY_H
 #define CELESTIAL_BODY_H
 
-#include "math3d.h"
+#include "../Utils/math3d.h"
 #include <stdint.h>
 
 #define MAX_NAME_LENGTH 20
@@ -22,7 +22,9 @@ typedef enum {
     SHADER_COUNT
 } ShaderType;
 
-typedef struct CelestialBody {
+// Descripción de un cuerpo: lo que no cambia de un frame a otro. El estado que se
+// actualiza por frame (órbita, posición, pantalla) vive en los arrays de SolarSystem.
+typedef struct {
     char name[MAX_NAME_LENGTH];
     BodyType type;
 
@@ -30,31 +32,14 @@ typedef struct CelestialBody {
     float mass;
     uint16_t color;
 
-    Vector3 position;
-
-    float rotation_angle;
     float rotation_speed;
 
     float orbit_radius;
-    float orbit_angle;
     float orbit_speed;
     float orbit_tilt;
 
     ShaderType shader_type;
 
-    struct CelestialBody* parent;
-
-    int16_t screen_x;
-    int16_t screen_y;
-    int16_t screen_radius;
-
-    int16_t prev_screen_x;
-    int16_t prev_screen_y;
-    int16_t prev_screen_radius;
-
-    float distance_to_camera;
-    uint8_t is_visible;
-
 } CelestialBody;
 
 void CelestialBody_Init(CelestialBody* body, const char* name, BodyType type);
@@ -62,9 +47,8 @@ void CelestialBody_SetOrbitalParams(CelestialBody* body, float radius, float spe
 void CelestialBody_SetRotation(CelestialBody* body, float speed);
 void CelestialBody_SetVisuals(CelestialBody* body, float radius, uint16_t color);
 void CelestialBody_SetShader(CelestialBody* body, ShaderType shader);
-void CelestialBody_SetParent(CelestialBody* body, CelestialBody* parent);
-void CelestialBody_Update(CelestialBody* body, float deltaTime);
-void CelestialBody_Render(CelestialBody* body);
-void CelestialBody_RenderWithShader(CelestialBody* body, float time);
+
+// Color del píxel (dx, dy) del disco de radio r; dx² + dy² <= r² lo garantiza quien llama
+uint16_t CelestialBody_Shade(const CelestialBody* body, int16_t r, int16_t dx, int16_t dy, float time);
 
 #endif
@@ -0,0 +1,297 @@
+#include "nbody.h"
+#include <math.h>
+
+static uint8_t used_tree = 0;
+
+#if NBODY_MAX_NODES > 0
+
+// Cubo del octree. Mientras se construye mx/my/mz suman masa * posición;
+// al terminar pasan a ser el centro de masas.
+typedef struct {
+    float cx, cy, cz;
+    float half;
+    float mx, my, mz;
+    float mass;
+    int32_t child;        // Primero de los 8 hijos contiguos, -1 en una hoja
+    int32_t body;         // Cuerpo de la hoja, -1 si está vacía
+} NBodyNode;
+
+static NBodyNode nodes[NBODY_MAX_NODES];
+static uint32_t node_count = 0;
+
+static inline uint8_t NBody_Octant(const NBodyNode* n, float x, float y, float z)
+{
+    return (x >= n->cx ? 1 : 0) | (y >= n->cy ? 2 : 0) | (z >= n->cz ? 4 : 0);
+}
+
+static inline void NBody_Accumulate(NBodyNode* n, float x, float y, float z, float m)
+{
+    n->mass += m;
+    n->mx += m * x;
+    n->my += m * y;
+    n->mz += m * z;
+}
+
+static void NBody_ResetNode(NBodyNode* n, float cx, float cy, float cz, float half)
+{
+    n->cx = cx;
+    n->cy = cy;
+    n->cz = cz;
+    n->half = half;
+    n->mx = 0.0f;
+    n->my = 0.0f;
+    n->mz = 0.0f;
+    n->mass = 0.0f;
+    n->child = -1;
+    n->body = -1;
+}
+
+static int32_t NBody_Split(const NBodyNode* parent)
+{
+    if (node_count + 8 > NBODY_MAX_NODES) return -1;
+
+    int32_t first = node_count;
+    float q = parent->half * 0.5f;
+
+    node_count += 8;
+    for (uint8_t k = 0; k < 8; k++) {
+        NBody_ResetNode(&nodes[first + k],
+                        parent->cx + ((k & 1) ? q : -q),
+                        parent->cy + ((k & 2) ? q : -q),
+                        parent->cz + ((k & 4) ? q : -q), q);
+    }
+    return first;
+}
+
+static uint8_t NBody_Insert(const NBodySet* set, int32_t i)
+{
+    float x = set->pos_x[i];
+    float y = set->pos_y[i];
+    float z = set->pos_z[i];
+    float m = set->mass[i];
+    NBodyNode* n = &nodes[0];
+
+    for (uint8_t depth = 0; ; depth++) {
+        if (n->child < 0) {
+            if (n->body < 0 || depth >= NBODY_MAX_DEPTH) {
+                if (n->body < 0) n->body = i;
+                NBody_Accumulate(n, x, y, z, m);
+                return 1;
+            }
+
+            // Hoja ocupada: se divide y lo que tenía baja un nivel entero
+            int32_t first = NBody_Split(n);
+            if (first < 0) return 0;
+
+            int32_t j = n->body;
+            NBodyNode* c = &nodes[first + NBody_Octant(n, set->pos_x[j], set->pos_y[j], set->pos_z[j])];
+            c->body = j;
+            c->mass = n->mass;
+            c->mx = n->mx;
+            c->my = n->my;
+            c->mz = n->mz;
+
+            n->child = first;
+            n->body = -1;
+        }
+
+        NBody_Accumulate(n, x, y, z, m);
+        n = &nodes[n->child + NBody_Octant(n, x, y, z)];
+    }
+}
+
+// 0 si no caben los nodos: el paso sigue con suma directa
+static uint8_t NBody_BuildTree(const NBodySet* set)
+{
+    float x0 = set->pos_x[0], x1 = x0;
+    float y0 = set->pos_y[0], y1 = y0;
+    float z0 = set->pos_z[0], z1 = z0;
+
+    for (uint32_t i = 1; i < set->count; i++) {
+        if (set->pos_x[i] < x0) x0 = set->pos_x[i];
+        if (set->pos_x[i] > x1) x1 = set->pos_x[i];
+        if (set->pos_y[i] < y0) y0 = set->pos_y[i];
+        if (set->pos_y[i] > y1) y1 = set->pos_y[i];
+        if (set->pos_z[i] < z0) z0 = set->pos_z[i];
+        if (set->pos_z[i] > z1) z1 = set->pos_z[i];
+    }
+
+    float half = 0.5f * fmaxf(x1 - x0, fmaxf(y1 - y0, z1 - z0));
+    half = half * 1.001f + 1e-6f;
+
+    node_count = 1;
+    NBody_ResetNode(&nodes[0], 0.5f * (x0 + x1), 0.5f * (y0 + y1), 0.5f * (z0 + z1), half);
+
+    for (uint32_t i = 0; i < set->count; i++) {
+        if (!NBody_Insert(set, i)) return 0;
+    }
+
+    for (uint32_t k = 0; k < node_count; k++) {
+        NBodyNode* n = &nodes[k];
+        if (n->mass <= 0.0f) continue;
+
+        float inv = 1.0f / n->mass;
+        n->mx *= inv;
+        n->my *= inv;
+        n->mz *= inv;
+    }
+
+    return 1;
+}
+
+// Hoja en la que quedó el cuerpo al insertarlo. Por debajo de NBODY_MAX_DEPTH la
+// comparten varios cuerpos y body solo guarda el primero.
+static int32_t NBody_FindLeaf(float x, float y, float z)
+{
+    int32_t k = 0;
+
+    while (nodes[k].child >= 0) {
+        k = nodes[k].child + NBody_Octant(&nodes[k], x, y, z);
+    }
+    return k;
+}
+
+static void NBody_TreeAcceleration(const NBodySet* set, uint32_t i, float* ax, float* ay, float* az)
+{
+    int32_t stack[NBODY_MAX_DEPTH * 7 + 8];
+    int32_t top = 0;
+
+    float x = set->pos_x[i];
+    float y = set->pos_y[i];
+    float z = set->pos_z[i];
+    float mi = set->mass[i];
+    int32_t self = NBody_FindLeaf(x, y, z);
+    float eps2 = set->softening * set->softening;
+    float theta2 = set->theta * set->theta;
+    float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+
+    stack[top++] = 0;
+
+    while (top > 0) {
+        int32_t k = stack[--top];
+        const NBodyNode* n = &nodes[k];
+        float m = n->mass;
+
+        if (m <= 0.0f) continue;
+
+        float dx = n->mx - x;
+        float dy = n->my - y;
+        float dz = n->mz - z;
+
+        if (n->child < 0) {
+            // La hoja del propio cuerpo: se quita su aportación
+            if (k == self) {
+                float rest = m - mi;
+                if (rest <= 0.0f) continue;
+
+                dx = (n->mx * m - x * mi) / rest - x;
+                dy = (n->my * m - y * mi) / rest - y;
+                dz = (n->mz * m - z * mi) / rest - z;
+                m = rest;
+            }
+        } else {
+            float d2 = dx * dx + dy * dy + dz * dz;
+            float size = 2.0f * n->half;
+
+            // Demasiado cerca para tratarlo como un punto: se abren los hijos
+            if (size * size >= theta2 * d2) {
+                for (uint8_t c = 0; c < 8; c++) {
+                    stack[top++] = n->child + c;
+                }
+                continue;
+            }
+        }
+
+        float r2 = dx * dx + dy * dy + dz * dz + eps2;
+        float inv = 1.0f / sqrtf(r2);
+        float f = m * inv * inv * inv;
+
+        sx += f * dx;
+        sy += f * dy;
+        sz += f * dz;
+    }
+
+    *ax = set->gravity * sx;
+    *ay = set->gravity * sy;
+    *az = set->gravity * sz;
+}
+
+#endif
+
+static void NBody_DirectAcceleration(const NBodySet* set, uint32_t i, float* ax, float* ay, float* az)
+{
+    float x = set->pos_x[i];
+    float y = set->pos_y[i];
+    float z = set->pos_z[i];
+    float eps2 = set->softening * set->softening;
+    float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+
+    for (uint32_t j = 0; j < set->count; j++) {
+        if (j == i) continue;
+
+        float dx = set->pos_x[j] - x;
+        float dy = set->pos_y[j] - y;
+        float dz = set->pos_z[j] - z;
+        float r2 = dx * dx + dy * dy + dz * dz + eps2;
+        float inv = 1.0f / sqrtf(r2);
+        float f = set->mass[j] * inv * inv * inv;
+
+        sx += f * dx;
+        sy += f * dy;
+        sz += f * dz;
+    }
+
+    *ax = set->gravity * sx;
+    *ay = set->gravity * sy;
+    *az = set->gravity * sz;
+}
+
+static void NBody_Acceleration(const NBodySet* set, uint32_t i, float* ax, float* ay, float* az)
+{
+#if NBODY_MAX_NODES > 0
+    if (used_tree) {
+        NBody_TreeAcceleration(set, i, ax, ay, az);
+        return;
+    }
+#endif
+    NBody_DirectAcceleration(set, i, ax, ay, az);
+}
+
+static void NBody_Drift(NBodySet* set, float dt)
+{
+    for (uint32_t i = 0; i < set->count; i++) {
+        set->pos_x[i] += set->vel_x[i] * dt;
+        set->pos_y[i] += set->vel_y[i] * dt;
+        set->pos_z[i] += set->vel_z[i] * dt;
+    }
+}
+
+void NBody_Step(NBodySet* set, float dt)
+{
+    if (set->count == 0) return;
+
+    NBody_Drift(set, 0.5f * dt);
+
+#if NBODY_MAX_NODES > 0
+    used_tree = (set->count > NBODY_DIRECT_MAX) && NBody_BuildTree(set);
+#endif
+
+    // Las posiciones no cambian durante el impulso: cada velocidad se actualiza
+    // en cuanto se conoce su aceleración, sin buffer intermedio
+    for (uint32_t i = 0; i < set->count; i++) {
+        float ax, ay, az;
+
+        NBody_Acceleration(set, i, &ax, &ay, &az);
+
+        set->vel_x[i] += ax * dt;
+        set->vel_y[i] += ay * dt;
+        set->vel_z[i] += az * dt;
+    }
+
+    NBody_Drift(set, 0.5f * dt);
+}
+
+uint8_t NBody_UsedTree(void)
+{
+    return used_tree;
+}
@@ -0,0 +1,47 @@
+#ifndef NBODY_H
+#define NBODY_H
+
+#include <stdint.h>
+
+// Nodos del octree de Barnes–Hut (40 bytes cada uno). En el MCU no hay árbol: con
+// MAX_BODIES cuerpos siempre va por suma directa. En el host se sube (de 4 a 8 nodos
+// por cuerpo); con 0 el árbol no se compila.
+#ifndef NBODY_MAX_NODES
+#define NBODY_MAX_NODES 0
+#endif
+
+// Hasta aquí la suma directa O(N²) sale más barata que construir el árbol
+#ifndef NBODY_DIRECT_MAX
+#define NBODY_DIRECT_MAX 64
+#endif
+
+// Por debajo de este nivel los cuerpos casi coincidentes comparten hoja
+#ifndef NBODY_MAX_DEPTH
+#define NBODY_MAX_DEPTH 24
+#endif
+
+// Vista sobre arrays ya existentes: el integrador escribe las posiciones en el
+// mismo almacén que lee el render
+typedef struct {
+    float* pos_x;
+    float* pos_y;
+    float* pos_z;
+    float* vel_x;
+    float* vel_y;
+    float* vel_z;
+    const float* mass;
+    uint32_t count;
+
+    float gravity;        // G
+    float softening;      // Evita aceleraciones enormes en encuentros cercanos
+    float theta;          // Apertura de Barnes–Hut: tamaño / distancia (0.5 típico)
+} NBodySet;
+
+// Un paso de leapfrog (deriva-impulso-deriva): simpléctico, la energía oscila
+// alrededor del valor inicial en lugar de derivar
+void NBody_Step(NBodySet* set, float dt);
+
+// 1 si el último paso usó el árbol, 0 si hizo suma directa (N pequeño o sin nodos)
+uint8_t NBody_UsedTree(void);
+
+#endif
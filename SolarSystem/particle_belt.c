@@ -0,0 +1,296 @@
+#include "particle_belt.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include "../Graphics/dirty_rect.h"
+#include <stdlib.h>
+#include <math.h>
+
+#define BELT_ONE_Q14    16384
+#define BELT_ONE_Q15    32767
+
+// Partículas renormalizadas por frame: cada una pasa cada 16 frames
+#define BELT_RENORM_SLICE  (BELT_MAX_PARTICLES / 16)
+
+#define BELT_POINT(x, y, shade, front)  ((uint32_t)(x) | ((uint32_t)(y) << 9) | ((uint32_t)(shade) << 17) | \
+                                         ((uint32_t)(front) << 19))
+#define BELT_POINT_X(p)          ((int16_t)((p) & 0x1FF))
+#define BELT_POINT_Y(p)          ((int16_t)(((p) >> 9) & 0xFF))
+#define BELT_POINT_SHADE(p)      (((p) >> 17) & (BELT_SHADES - 1))
+#define BELT_POINT_FRONT(p)      (((p) >> 19) & 1)
+
+void Belt_Init(ParticleBelt* belt, uint16_t count, float inner_radius, float outer_radius,
+               float thickness, float speed, uint32_t seed)
+{
+    if (count > BELT_MAX_PARTICLES) count = BELT_MAX_PARTICLES;
+
+    belt->count = count;
+    belt->active = count;
+    belt->visible = 0;
+    belt->inner_radius = inner_radius;
+    belt->outer_radius = outer_radius;
+    belt->thickness = thickness;
+    belt->renorm_next = 0;
+
+    // Tercera ley de Kepler en el radio medio de cada carril
+    for (uint8_t l = 0; l < BELT_LANES; l++) {
+        float r = inner_radius + (outer_radius - inner_radius) * (l + 0.5f) / BELT_LANES;
+        belt->lane_speed[l] = speed * powf(inner_radius / r, 1.5f);
+        belt->rotor_c[l] = BELT_ONE_Q15;
+        belt->rotor_s[l] = 0;
+    }
+
+    srand(seed);
+
+    for (uint16_t i = 0; i < count; i++) {
+        BeltParticle* p = &belt->particles[i];
+        float angle = (rand() % 3600) * (TWO_PI / 3600.0f);
+
+        p->c = (int16_t)(cosf(angle) * BELT_ONE_Q14);
+        p->s = (int16_t)(sinf(angle) * BELT_ONE_Q14);
+
+        // Media de dos tiradas: más densidad en el centro del cinturón
+        p->radius = (uint8_t)(((rand() & 0xFF) + (rand() & 0xFF)) >> 1);
+        p->height = (int8_t)((rand() % 255) - 127);
+    }
+
+    for (uint8_t b = 0; b <= BELT_BINS; b++) {
+        belt->bin_start[b] = 0;
+    }
+
+    belt->box_x0 = belt->box_y0 = 0;
+    belt->box_x1 = belt->box_y1 = -1;
+    belt->prev_x0 = belt->prev_y0 = 0;
+    belt->prev_x1 = belt->prev_y1 = -1;
+
+    Belt_SetColor(belt, 0x8C71);
+}
+
+// Tonos al 100, 75, 62 y 50 % del color base
+void Belt_SetColor(ParticleBelt* belt, uint16_t color)
+{
+    static const uint8_t scale[BELT_SHADES] = { 32, 24, 20, 16 };
+
+    for (uint8_t i = 0; i < BELT_SHADES; i++) {
+        uint16_t r = ((color >> 11) & 0x1F) * scale[i] / 32;
+        uint16_t g = ((color >> 5) & 0x3F) * scale[i] / 32;
+        uint16_t b = (color & 0x1F) * scale[i] / 32;
+        belt->shades[i] = (r << 11) | (g << 5) | b;
+    }
+}
+
+void Belt_Update(ParticleBelt* belt, float deltaTime)
+{
+    for (uint8_t l = 0; l < BELT_LANES; l++) {
+        belt->lane_angle[l] = belt->lane_speed[l] * deltaTime;
+    }
+
+    sincos_batch(belt->lane_angle, belt->lane_sin, belt->lane_cos, BELT_LANES);
+
+    for (uint8_t l = 0; l < BELT_LANES; l++) {
+        belt->rotor_c[l] = (int16_t)lrintf(belt->lane_cos[l] * BELT_ONE_Q15);
+        belt->rotor_s[l] = (int16_t)lrintf(belt->lane_sin[l] * BELT_ONE_Q15);
+    }
+
+    // (c + is) * (rc + irs), con redondeo para no sesgar el módulo
+    BeltParticle* p = belt->particles;
+    for (uint16_t i = 0; i < belt->active; i++, p++) {
+        uint8_t lane = p->radius >> 4;
+        int32_t rc = belt->rotor_c[lane];
+        int32_t rs = belt->rotor_s[lane];
+        int32_t c = p->c;
+        int32_t s = p->s;
+
+        p->c = (int16_t)((c * rc - s * rs + (1 << 14)) >> 15);
+        p->s = (int16_t)((c * rs + s * rc + (1 << 14)) >> 15);
+    }
+
+    // Un paso de Newton hacia |v| = 1 sobre un tramo distinto en cada frame
+    if (belt->renorm_next >= belt->active) belt->renorm_next = 0;
+
+    uint16_t end = belt->renorm_next + BELT_RENORM_SLICE;
+    if (end > belt->active) end = belt->active;
+
+    for (uint16_t i = belt->renorm_next; i < end; i++) {
+        p = &belt->particles[i];
+        int32_t c = p->c;
+        int32_t s = p->s;
+        int32_t m2 = (c * c + s * s) >> 14;
+        int32_t k = (3 * BELT_ONE_Q14 - m2) >> 1;
+
+        p->c = (int16_t)((c * k) >> 14);
+        p->s = (int16_t)((s * k) >> 14);
+    }
+
+    belt->renorm_next = (end >= belt->active) ? 0 : end;
+}
+
+void Belt_Project(ParticleBelt* belt, Camera* cam, Vector3 center)
+{
+    // clip = (center + (r·c, h, r·s)) * view_projection: el centro se proyecta una
+    // vez y cada partícula suma tres filas de la matriz, para x, y y w
+    const Matrix4x4* m = &cam->view_projection;
+    float base[4];
+
+    for (uint8_t k = 0; k < 4; k++) {
+        base[k] = center.x * m->m[0][k] + center.y * m->m[1][k] + center.z * m->m[2][k] + m->m[3][k];
+    }
+
+    float step = (belt->outer_radius - belt->inner_radius) / 255.0f;
+    float h_scale = belt->thickness / 127.0f;
+    float half_w = 0.5f * LCD_WIDTH;
+    float half_h = 0.5f * LCD_HEIGHT;
+
+    uint16_t bin_count[BELT_BINS];
+    for (uint8_t b = 0; b < BELT_BINS; b++) {
+        bin_count[b] = 0;
+    }
+
+    int16_t x0 = LCD_WIDTH, y0 = LCD_HEIGHT, x1 = -1, y1 = -1;
+    uint16_t visible = 0;
+
+    for (uint16_t i = 0; i < belt->active; i++) {
+        const BeltParticle* p = &belt->particles[i];
+        float r = (belt->inner_radius + p->radius * step) / BELT_ONE_Q14;
+        float c = r * p->c;
+        float s = r * p->s;
+        float h = p->height * h_scale;
+
+        float w = base[3] + c * m->m[0][3] + h * m->m[1][3] + s * m->m[2][3];
+        if (w <= cam->near_plane) continue;
+
+        float inv_w = 1.0f / w;
+        float cx = base[0] + c * m->m[0][0] + h * m->m[1][0] + s * m->m[2][0];
+        float cy = base[1] + c * m->m[0][1] + h * m->m[1][1] + s * m->m[2][1];
+
+        int16_t x = (int16_t)((cx * inv_w + 1.0f) * half_w);
+        int16_t y = (int16_t)((1.0f - cy * inv_w) * half_h);
+
+        if (x < 0 || x >= LCD_WIDTH || y < 0 || y >= LCD_HEIGHT) continue;
+
+        if (x < x0) x0 = x;
+        if (x > x1) x1 = x;
+        if (y < y0) y0 = y;
+        if (y > y1) y1 = y;
+
+        // Más cerca que el centro: se dibuja delante de los cuerpos
+        bin_count[y / BELT_BIN_ROWS]++;
+        belt->points[visible++] = BELT_POINT(x, y, i & (BELT_SHADES - 1), w < base[3]);
+    }
+
+    // Ordenamiento por conteo sobre el mismo array: cada cubeta queda contigua para
+    // dibujarla de una vez. bin_count pasa a ser el siguiente hueco de cada cubeta.
+    uint16_t sum = 0;
+    for (uint8_t b = 0; b < BELT_BINS; b++) {
+        belt->bin_start[b] = sum;
+        sum += bin_count[b];
+        bin_count[b] = belt->bin_start[b];
+    }
+    belt->bin_start[BELT_BINS] = sum;
+
+    // Cada intercambio deja un punto en su cubeta: a lo sumo visible intercambios
+    for (uint8_t b = 0; b < BELT_BINS; b++) {
+        while (bin_count[b] < belt->bin_start[b + 1]) {
+            uint32_t point = belt->points[bin_count[b]];
+            uint8_t dest = BELT_POINT_Y(point) / BELT_BIN_ROWS;
+
+            if (dest == b) {
+                bin_count[b]++;
+                continue;
+            }
+
+            belt->points[bin_count[b]] = belt->points[bin_count[dest]];
+            belt->points[bin_count[dest]++] = point;
+        }
+    }
+
+    belt->visible = visible;
+    belt->box_x0 = x0;
+    belt->box_y0 = y0;
+    belt->box_x1 = x1;
+    belt->box_y1 = y1;
+}
+
+void Belt_FitBudget(ParticleBelt* belt, uint32_t spent, uint32_t budget)
+{
+    uint16_t min_active = (belt->count < BELT_MIN_ACTIVE) ? belt->count : BELT_MIN_ACTIVE;
+    uint32_t fit = belt->count;
+
+    // El coste es proporcional a las activas. Baja en el acto y sube como mucho un
+    // octavo por frame, para no oscilar con el ruido de la medida.
+    if (spent > 0) {
+        fit = (uint32_t)((uint64_t)belt->active * budget / spent);
+
+        uint32_t grow = belt->active + belt->active / 8 + 1;
+        if (fit > grow) fit = grow;
+    }
+
+    if (fit > belt->count) fit = belt->count;
+    if (fit < min_active) fit = min_active;
+
+    belt->active = (uint16_t)fit;
+}
+
+static void Belt_DrawPoints(ParticleBelt* belt, CompositorTile* tile, uint32_t front)
+{
+    int16_t tx1 = tile->x + tile->w;
+    int16_t ty1 = tile->y + tile->h;
+
+    if (belt->visible == 0 || tile->y > belt->box_y1 || ty1 <= belt->box_y0) return;
+
+    uint8_t b0 = tile->y / BELT_BIN_ROWS;
+    uint8_t b1 = (ty1 - 1) / BELT_BIN_ROWS;
+    if (b1 >= BELT_BINS) b1 = BELT_BINS - 1;
+
+    const uint32_t* point = &belt->points[belt->bin_start[b0]];
+    const uint32_t* end = &belt->points[belt->bin_start[b1 + 1]];
+
+    // Ráfaga sobre las cubetas de la región, escribiendo directo en la fila
+    for (; point < end; point++) {
+        int16_t x = BELT_POINT_X(*point);
+        int16_t y = BELT_POINT_Y(*point);
+
+        if (BELT_POINT_FRONT(*point) != front) continue;
+        if (x < tile->x || x >= tx1 || y < tile->y || y >= ty1) continue;
+
+        tile->pixels[(int32_t)(y - tile->y) * tile->w + (x - tile->x)] = belt->shades[BELT_POINT_SHADE(*point)];
+    }
+}
+
+void Belt_BackLayer(void* ctx, CompositorTile* tile)
+{
+    Belt_DrawPoints((ParticleBelt*)ctx, tile, 0);
+}
+
+void Belt_FrontLayer(void* ctx, CompositorTile* tile)
+{
+    Belt_DrawPoints((ParticleBelt*)ctx, tile, 1);
+}
+
+void Belt_MarkDirty(ParticleBelt* belt)
+{
+    // Todo el cinturón se mueve en cada frame: se recompone su caja entera
+    if (belt->prev_x1 >= belt->prev_x0) {
+        Dirty_Add(belt->prev_x0, belt->prev_y0, belt->prev_x1 - belt->prev_x0 + 1, belt->prev_y1 - belt->prev_y0 + 1);
+    }
+
+    if (belt->box_x1 >= belt->box_x0) {
+        Dirty_Add(belt->box_x0, belt->box_y0, belt->box_x1 - belt->box_x0 + 1, belt->box_y1 - belt->box_y0 + 1);
+    }
+
+    belt->prev_x0 = belt->box_x0;
+    belt->prev_y0 = belt->box_y0;
+    belt->prev_x1 = belt->box_x1;
+    belt->prev_y1 = belt->box_y1;
+}
+
+void Belt_ScrollScreen(ParticleBelt* belt, int16_t dx)
+{
+    if (belt->prev_x1 < belt->prev_x0) return;
+
+    belt->prev_x0 -= dx;
+    belt->prev_x1 -= dx;
+
+    // Lo que sale por la izquierda reaparece por la derecha con la vuelta de la RAM
+    if (belt->prev_x0 < 0) {
+        Dirty_Add(LCD_WIDTH + belt->prev_x0, belt->prev_y0, -belt->prev_x0, belt->prev_y1 - belt->prev_y0 + 1);
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef PARTICLE_BELT_H
+#define PARTICLE_BELT_H
+
+#include "camera.h"
+#include "../Graphics/compositor.h"
+#include "../Graphics/indexed_fb.h"
+#include <stdint.h>
+
+// 10 bytes por partícula entre estado y punto proyectado (20 KB con 2048). Con el
+// framebuffer indexado en RAM el cinturón se queda en 5 KB.
+#ifndef BELT_MAX_PARTICLES
+#if INDEXED_FB_ENABLE
+#define BELT_MAX_PARTICLES 512
+#else
+#define BELT_MAX_PARTICLES 2048
+#endif
+#endif
+
+// Carriles radiales: todas las partículas de un carril giran con el mismo rotor
+#define BELT_LANES      16
+
+// Filas de pantalla por cubeta (240 / 8)
+#define BELT_BIN_ROWS   8
+#define BELT_BINS       30
+
+#define BELT_SHADES     4
+
+// Partículas que quedan activas aunque el presupuesto del frame no llegue
+#define BELT_MIN_ACTIVE 256
+
+// Fase guardada como vector unitario en Q14: avanzar es multiplicar por un rotor
+typedef struct {
+    int16_t c;
+    int16_t s;
+    uint8_t radius;       // 0 = borde interior, 255 = borde exterior
+    int8_t height;        // Altura sobre el plano, en fracciones del espesor
+} BeltParticle;
+
+typedef struct {
+    BeltParticle particles[BELT_MAX_PARTICLES];
+
+    // Puntos proyectados empaquetados (x, y, tono, delante), ordenados por cubeta de filas
+    uint32_t points[BELT_MAX_PARTICLES];
+    uint16_t bin_start[BELT_BINS + 1];
+    uint16_t count;
+    uint16_t visible;
+
+    // Presupuesto: solo las primeras active partículas se avanzan, proyectan y dibujan
+    uint16_t active;
+
+    float inner_radius;
+    float outer_radius;
+    float thickness;
+
+    // Velocidad angular de cada carril (Kepler) y rotor del frame en Q15
+    float lane_speed[BELT_LANES];
+    float lane_angle[BELT_LANES];
+    float lane_sin[BELT_LANES];
+    float lane_cos[BELT_LANES];
+    int16_t rotor_c[BELT_LANES];
+    int16_t rotor_s[BELT_LANES];
+
+    // Siguiente tramo a renormalizar (el redondeo encoge el vector poco a poco)
+    uint16_t renorm_next;
+
+    uint16_t shades[BELT_SHADES];
+
+    // Caja de los puntos en pantalla: frame actual y lo último enviado al panel
+    int16_t box_x0, box_y0, box_x1, box_y1;
+    int16_t prev_x0, prev_y0, prev_x1, prev_y1;
+
+} ParticleBelt;
+
+// Reparte count partículas al azar entre los dos radios; speed es la velocidad
+// angular (rad/s) en el borde interior y cae con r^-1.5 hacia fuera
+void Belt_Init(ParticleBelt* belt, uint16_t count, float inner_radius, float outer_radius,
+               float thickness, float speed, uint32_t seed);
+void Belt_SetColor(ParticleBelt* belt, uint16_t color);
+
+// Sin trigonometría por partícula: un sincos por carril y cuatro productos por partícula
+void Belt_Update(ParticleBelt* belt, float deltaTime);
+
+// Proyecta en perspectiva alrededor de center y ordena los puntos por filas de pantalla
+void Belt_Project(ParticleBelt* belt, Camera* cam, Vector3 center);
+
+// Ajusta las partículas activas para que el siguiente frame cueste budget: spent es
+// lo que costaron Belt_Update y Belt_Project con las actuales, en las mismas unidades.
+// Las partículas están repartidas al azar, así que menos activas es un anillo más tenue.
+void Belt_FitBudget(ParticleBelt* belt, uint32_t spent, uint32_t budget);
+
+// Capas para el compositor: la mitad lejana va detrás de los cuerpos y la cercana
+// delante. Solo recorren las cubetas que tocan la región.
+void Belt_BackLayer(void* ctx, CompositorTile* tile);
+void Belt_FrontLayer(void* ctx, CompositorTile* tile);
+
+void Belt_MarkDirty(ParticleBelt* belt);
+void Belt_ScrollScreen(ParticleBelt* belt, int16_t dx);
+
+#endif
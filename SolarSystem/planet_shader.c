@@ -1,4 +1,5 @@
 #include "planet_shader.h"
+#include "../Graphics/blend.h"
 #include <math.h>
 
 uint16_t RGB_To_RGB565(uint8_t r, uint8_t g, uint8_t b)
@@ -133,14 +134,17 @@ uint16_t Shader_Earth(ShaderInput* input)
                        input->position.z * 10.0f, 3);
     clouds = Smoothstep(0.55f, 0.75f, clouds);
 
+    uint16_t surface = RGB_To_RGB565(r, g, b);
+
     if (clouds > 0.5f) {
-        float cloud_alpha = (clouds - 0.5f) * 2.0f;
-        r = (uint8_t)(r * (1.0f - cloud_alpha) + 240.0f * cloud_alpha * light);
-        g = (uint8_t)(g * (1.0f - cloud_alpha) + 240.0f * cloud_alpha * light);
-        b = (uint8_t)(b * (1.0f - cloud_alpha) + 250.0f * cloud_alpha * light);
+        uint16_t cloud = RGB_To_RGB565((uint8_t)(240.0f * light),
+                                       (uint8_t)(240.0f * light),
+                                       (uint8_t)(250.0f * light));
+        uint8_t cloud_alpha = (uint8_t)((clouds - 0.5f) * 2.0f * BLEND_ALPHA_MAX);
+        return Blend_RGB565(cloud, surface, cloud_alpha);
     }
 
-    return RGB_To_RGB565(r, g, b);
+    return surface;
 }
 
 uint16_t Shader_Jupiter(ShaderInput* input)
@@ -211,3 +215,44 @@ uint16_t Shader_Neptune(ShaderInput* input)
 
     return RGB_To_RGB565(r, g, b);
 }
+
+// Colores a plena luz de cada shader; la paleta los recorre de negro a ese color
+typedef struct {
+    uint8_t r, g, b;
+} ShaderRampKey;
+
+static const ShaderRampKey ramp_mercury[] = { {255, 242, 230} };
+static const ShaderRampKey ramp_venus[]   = { {250, 220, 120} };
+static const ShaderRampKey ramp_earth[]   = { {40, 150, 30}, {10, 100, 170}, {240, 240, 250} };
+static const ShaderRampKey ramp_jupiter[] = { {180, 130, 80}, {255, 190, 120} };
+static const ShaderRampKey ramp_saturn[]  = { {220, 190, 140}, {255, 220, 165} };
+static const ShaderRampKey ramp_neptune[] = { {20, 80, 180}, {100, 180, 255} };
+
+uint16_t Shader_BuildPalette(ShaderType shader, uint16_t* palette, uint16_t max_colors)
+{
+    const ShaderRampKey* keys;
+    uint8_t key_count;
+
+    switch (shader) {
+        case SHADER_MERCURY: keys = ramp_mercury; key_count = 1; break;
+        case SHADER_VENUS: keys = ramp_venus; key_count = 1; break;
+        case SHADER_EARTH: keys = ramp_earth; key_count = 3; break;
+        case SHADER_JUPITER: keys = ramp_jupiter; key_count = 2; break;
+        case SHADER_SATURN: keys = ramp_saturn; key_count = 2; break;
+        case SHADER_NEPTUNE: keys = ramp_neptune; key_count = 2; break;
+        default: return 0;
+    }
+
+    uint16_t levels = max_colors / key_count;
+    uint16_t count = 0;
+
+    for (uint8_t k = 0; k < key_count; k++) {
+        for (uint16_t i = 1; i <= levels; i++) {
+            palette[count++] = RGB_To_RGB565((uint8_t)(keys[k].r * i / levels),
+                                             (uint8_t)(keys[k].g * i / levels),
+                                             (uint8_t)(keys[k].b * i / levels));
+        }
+    }
+
+    return count;
+}
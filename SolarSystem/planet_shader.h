@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "../Utils/math3d.h"
+#include "celestial_body.h"
 
 typedef struct {
     Vector3 position;
@@ -21,4 +22,7 @@ uint16_t RGB_To_RGB565(uint8_t r, uint8_t g, uint8_t b);
 float Noise(float x, float y);
 float FBM(float x, float y, int octaves);
 
+// Paleta de rampas de color del shader (para el framebuffer indexado)
+uint16_t Shader_BuildPalette(ShaderType shader, uint16_t* palette, uint16_t max_colors);
+
 #endif
@@ -1,5 +1,7 @@
 #include "solar_system.h"
 #include "../Drivers/LCD/lcd_driver.h"
+#include "../Graphics/dirty_rect.h"
+#include "../Graphics/blend.h"
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
@@ -9,6 +11,8 @@ void SolarSystem_Init(SolarSystem* sys)
     sys->body_count = 0;
     sys->time_scale = 1.0f;
     sys->total_time = 0.0f;
+    sys->render_time = 0.0f;
+    sys->gravity = 0.0f;
 
     SolarSystem_CreateDefaultSystem(sys);
 }
@@ -21,143 +25,754 @@ void SolarSystem_CreateDefaultSystem(SolarSystem* sys)
     CelestialBody_SetVisuals(&body, 60.0f, COLOR_EARTH);
     CelestialBody_SetRotation(&body, 0.2f);
     CelestialBody_SetShader(&body, SHADER_MERCURY);
-    SolarSystem_AddBody(sys, body);
+    SolarSystem_AddBody(sys, &body, BODY_NONE);
 }
 
-void SolarSystem_AddBody(SolarSystem* sys, CelestialBody body)
+BodyHandle SolarSystem_AddBody(SolarSystem* sys, const CelestialBody* body, BodyHandle parent)
 {
-    if (sys->body_count < MAX_BODIES) {
-        sys->bodies[sys->body_count] = body;
-        sys->body_count++;
-    }
+    if (sys->body_count >= MAX_BODIES) return BODY_NONE;
+    if (parent != BODY_NONE && parent >= sys->body_count) return BODY_NONE;
+
+    BodyHandle h = sys->body_count++;
+
+    sys->info[h] = *body;
+
+    sys->orbit_radius[h] = body->orbit_radius;
+    sys->orbit_angle[h] = 0.0f;
+    sys->orbit_speed[h] = body->orbit_speed;
+    sys->orbit_tilt[h] = body->orbit_tilt;
+    sys->orbit_tilt_sin[h] = sinf(body->orbit_tilt);
+    sys->orbit_sin[h] = 0.0f;
+    sys->orbit_cos[h] = 1.0f;
+    sys->rotation_angle[h] = 0.0f;
+    sys->rotation_speed[h] = body->rotation_speed;
+    sys->parent[h] = parent;
+
+    sys->pos_x[h] = 0.0f;
+    sys->pos_y[h] = 0.0f;
+    sys->pos_z[h] = 0.0f;
+
+    sys->vel_x[h] = 0.0f;
+    sys->vel_y[h] = 0.0f;
+    sys->vel_z[h] = 0.0f;
+    sys->mass[h] = body->mass;
+
+    sys->screen_x[h] = 0;
+    sys->screen_y[h] = 0;
+    sys->screen_radius[h] = 0;
+    sys->prev_screen_x[h] = -1000;
+    sys->prev_screen_y[h] = -1000;
+    sys->prev_screen_radius[h] = 0;
+    sys->distance_to_camera[h] = 0.0f;
+    sys->is_visible[h] = 0;
+#if SOLAR_ORBITS_ENABLE
+    sys->orbit_cache[h].valid = 0;
+    sys->orbit_cache[h].shown_x0 = 1;
+    sys->orbit_cache[h].shown_x1 = 0;
+#endif
+#if SOLAR_TRAILS_ENABLE
+    sys->trail[h].head = 0;
+    sys->trail[h].count = 0;
+    sys->trail[h].enabled = 0;
+#endif
+
+    // Los cuerpos nuevos se dibujan al final hasta el siguiente ordenamiento
+    sys->draw_order[h] = h;
+
+    return h;
 }
 
 void SolarSystem_Update(SolarSystem* sys, float deltaTime)
 {
     float scaled_time = deltaTime * sys->time_scale;
+    uint8_t count = sys->body_count;
+
     sys->total_time += scaled_time;
 
-    for (uint8_t i = 0; i < sys->body_count; i++) {
-        CelestialBody_Update(&sys->bodies[i], scaled_time);
+    // Ángulos de todos los cuerpos: sin dependencias entre iteraciones
+    for (BodyHandle h = 0; h < count; h++) {
+        sys->rotation_angle[h] += sys->rotation_speed[h] * scaled_time;
+        if (sys->rotation_angle[h] > TWO_PI) {
+            sys->rotation_angle[h] -= TWO_PI;
+        }
+    }
+
+    if (sys->gravity > 0.0f) {
+        NBodySet set;
+
+        set.pos_x = sys->pos_x;
+        set.pos_y = sys->pos_y;
+        set.pos_z = sys->pos_z;
+        set.vel_x = sys->vel_x;
+        set.vel_y = sys->vel_y;
+        set.vel_z = sys->vel_z;
+        set.mass = sys->mass;
+        set.count = count;
+        set.gravity = sys->gravity;
+        set.softening = 1.0f;
+        set.theta = 0.5f;
+
+        NBody_Step(&set, scaled_time);
+        return;
+    }
+
+    for (BodyHandle h = 0; h < count; h++) {
+        sys->orbit_angle[h] += sys->orbit_speed[h] * scaled_time;
+        if (sys->orbit_angle[h] > TWO_PI) {
+            sys->orbit_angle[h] -= TWO_PI;
+        }
+    }
+
+    // Un solo seno y coseno por órbita; el seno de la inclinación es fijo (AddBody)
+    sincos_batch(sys->orbit_angle, sys->orbit_sin, sys->orbit_cos, count);
+
+    // Un padre siempre tiene un handle menor que sus hijos, así que el orden de
+    // handles ya es topológico: cada hijo ve la posición del padre de este frame
+    for (BodyHandle h = 0; h < count; h++) {
+        float r = sys->orbit_radius[h];
+
+        if (r <= 0.0f) continue;
+
+        float x = r * sys->orbit_cos[h];
+        float z = r * sys->orbit_sin[h];
+        float y = r * sys->orbit_tilt_sin[h] * sys->orbit_sin[h];
+        BodyHandle p = sys->parent[h];
+
+        if (p != BODY_NONE) {
+            x += sys->pos_x[p];
+            y += sys->pos_y[p];
+            z += sys->pos_z[p];
+        }
+
+        sys->pos_x[h] = x;
+        sys->pos_y[h] = y;
+        sys->pos_z[h] = z;
     }
 }
 
-void SolarSystem_SortByDistance(SolarSystem* sys, Camera* cam)
+void SolarSystem_SetGravity(SolarSystem* sys, float gravity)
 {
-    for (uint8_t i = 0; i < sys->body_count; i++) {
-        sys->bodies[i].distance_to_camera =
-            vec3_distance(cam->position, sys->bodies[i].position);
+    // Con 0 cada cuerpo vuelve a su órbita circular en el ángulo en que la dejó
+    if (gravity <= 0.0f) {
+        sys->gravity = 0.0f;
+        return;
     }
 
-    for (uint8_t i = 0; i < sys->body_count - 1; i++) {
-        for (uint8_t j = 0; j < sys->body_count - i - 1; j++) {
-            if (sys->bodies[j].distance_to_camera < sys->bodies[j + 1].distance_to_camera) {
-                CelestialBody temp = sys->bodies[j];
-                sys->bodies[j] = sys->bodies[j + 1];
-                sys->bodies[j + 1] = temp;
+    if (sys->gravity <= 0.0f) {
+        // Derivada de la órbita circular (ver SolarSystem_Update) más la del padre
+        for (BodyHandle h = 0; h < sys->body_count; h++) {
+            float w = sys->orbit_speed[h] * sys->orbit_radius[h];
+            float vx = -w * sys->orbit_sin[h];
+            float vy = w * sys->orbit_tilt_sin[h] * sys->orbit_cos[h];
+            float vz = w * sys->orbit_cos[h];
+            BodyHandle p = sys->parent[h];
+
+            if (p != BODY_NONE) {
+                vx += sys->vel_x[p];
+                vy += sys->vel_y[p];
+                vz += sys->vel_z[p];
             }
+
+            sys->vel_x[h] = vx;
+            sys->vel_y[h] = vy;
+            sys->vel_z[h] = vz;
+        }
+    }
+
+    sys->gravity = gravity;
+}
+
+void SolarSystem_SortByDistance(SolarSystem* sys, Camera* cam)
+{
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        sys->distance_to_camera[h] = vec3_distance(cam->position, SolarSystem_GetPosition(sys, h));
+    }
+
+    // Inserción sobre la permutación del frame anterior: casi siempre ya está
+    // ordenada y la pasada es lineal. Solo se mueven índices de un byte.
+    BodyHandle* order = sys->draw_order;
+
+    for (uint8_t i = 1; i < sys->body_count; i++) {
+        BodyHandle h = order[i];
+        float d = sys->distance_to_camera[h];
+        uint8_t j = i;
+
+        while (j > 0 && sys->distance_to_camera[order[j - 1]] < d) {
+            order[j] = order[j - 1];
+            j--;
         }
+        order[j] = h;
     }
 }
 
-void SolarSystem_Render(SolarSystem* sys, Camera* cam)
+// Posición en pantalla de todos los cuerpos y orden de dibujo. Los que quedan fuera
+// del frustum o de la pantalla se marcan invisibles y no llegan a sombrearse.
+static void SolarSystem_Project(SolarSystem* sys, Camera* cam)
 {
     SolarSystem_SortByDistance(sys, cam);
 
-    for (uint8_t i = 0; i < sys->body_count; i++) {
-        CelestialBody* body = &sys->bodies[i];
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        Vector2 screen_pos;
+        float screen_radius;
+
+        sys->is_visible[h] = Camera_ProjectSphere(cam, SolarSystem_GetPosition(sys, h), sys->info[h].radius,
+                                                  LCD_WIDTH, LCD_HEIGHT, &screen_pos, &screen_radius);
+        if (!sys->is_visible[h]) continue;
+
+        // Un disco más grande que BODY_SCREEN_RADIUS_MAX se acerca al centro de la
+        // pantalla y encoge lo mismo: conserva su punto más cercano a la pantalla y
+        // el centro y el radio caben en int16_t
+        float x = screen_pos.x;
+        float y = screen_pos.y;
+
+        if (screen_radius > BODY_SCREEN_RADIUS_MAX) {
+            float to_x = LCD_WIDTH * 0.5f - x;
+            float to_y = LCD_HEIGHT * 0.5f - y;
+            float d = sqrtf(to_x * to_x + to_y * to_y);
+            float shift = screen_radius - BODY_SCREEN_RADIUS_MAX;
+
+            // Con el centro de la pantalla tan dentro del disco, la tapa entera
+            if (d <= shift) {
+                shift = d;
+            }
+            if (d > 0.0f) {
+                x += to_x * shift / d;
+                y += to_y * shift / d;
+            }
+            screen_radius = BODY_SCREEN_RADIUS_MAX;
+        }
 
-        Vector2 screen_pos = Camera_WorldToScreen(cam, body->position, LCD_WIDTH, LCD_HEIGHT);
+        sys->screen_x[h] = (int16_t)x;
+        sys->screen_y[h] = (int16_t)y;
 
-        body->screen_x = (int16_t)screen_pos.x;
-        body->screen_y = (int16_t)screen_pos.y;
+        // Un punto como mínimo
+        int16_t r = (int16_t)(screen_radius + 0.5f);
+        if (r < 1) r = 1;
+        sys->screen_radius[h] = r;
+    }
+}
 
-        body->screen_radius = (int16_t)(body->radius * 1.2f);
+// Celdas de la rejilla que toca el disco de cada cuerpo visible
+static void SolarSystem_BinBodies(SolarSystem* sys)
+{
+    memset(sys->tile_bodies, 0, sizeof(sys->tile_bodies));
+
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        if (!sys->is_visible[h]) continue;
+
+        int16_t r = sys->screen_radius[h];
+        int16_t x0 = sys->screen_x[h] - r;
+        int16_t y0 = sys->screen_y[h] - r;
+        int16_t x1 = sys->screen_x[h] + r;
+        int16_t y1 = sys->screen_y[h] + r;
+
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 >= LCD_WIDTH) x1 = LCD_WIDTH - 1;
+        if (y1 >= LCD_HEIGHT) y1 = LCD_HEIGHT - 1;
+        if (x0 > x1 || y0 > y1) continue;
+
+        for (int16_t ty = y0 / BODY_TILE_SIZE; ty <= y1 / BODY_TILE_SIZE; ty++) {
+            for (int16_t tx = x0 / BODY_TILE_SIZE; tx <= x1 / BODY_TILE_SIZE; tx++) {
+                sys->tile_bodies[ty][tx] |= 1u << h;
+            }
+        }
+    }
+}
 
-        if (body->screen_radius < 2) body->screen_radius = 2;
-        if (body->screen_radius > 100) body->screen_radius = 100;
+// Cuerpos de las celdas que toca el rectángulo (coordenadas inclusivas)
+static uint16_t SolarSystem_BodiesIn(const SolarSystem* sys, int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    uint16_t mask = 0;
 
-        body->is_visible = 1;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= LCD_WIDTH) x1 = LCD_WIDTH - 1;
+    if (y1 >= LCD_HEIGHT) y1 = LCD_HEIGHT - 1;
+    if (x0 > x1 || y0 > y1) return 0;
 
-        CelestialBody_Render(body);
+    for (int16_t ty = y0 / BODY_TILE_SIZE; ty <= y1 / BODY_TILE_SIZE; ty++) {
+        for (int16_t tx = x0 / BODY_TILE_SIZE; tx <= x1 / BODY_TILE_SIZE; tx++) {
+            mask |= sys->tile_bodies[ty][tx];
+        }
     }
+    return mask;
 }
 
-void SolarSystem_RenderWithShaders(SolarSystem* sys, Camera* cam, float time)
+#if SOLAR_ORBITS_ENABLE
+// Proyecta los vértices de la órbita. El punto avanza con una rotación fija
+// (recurrencia de senos y cosenos): ninguna llamada trigonométrica por vértice.
+static void SolarSystem_BuildOrbit(SolarSystem* sys, BodyHandle h, Camera* cam, Vector3 center)
 {
-    SolarSystem_SortByDistance(sys, cam);
+    static float step_c = 0.0f;
+    static float step_s = 0.0f;
 
-    for (uint8_t i = 0; i < sys->body_count; i++) {
-        CelestialBody* body = &sys->bodies[i];
+    if (step_c == 0.0f) {
+        step_c = cosf(TWO_PI / ORBIT_POINTS);
+        step_s = sinf(TWO_PI / ORBIT_POINTS);
+    }
 
-        Vector2 screen_pos = Camera_WorldToScreen(cam, body->position, LCD_WIDTH, LCD_HEIGHT);
+    OrbitCache* cache = &sys->orbit_cache[h];
+    float r = sys->orbit_radius[h];
+    float tilt = sys->orbit_tilt_sin[h];
+    float c = 1.0f;
+    float s = 0.0f;
+
+    // Sin vértices visibles la caja queda vacía (x0 > x1)
+    cache->x0 = cache->y0 = INT16_MAX;
+    cache->x1 = cache->y1 = INT16_MIN;
+
+    for (uint16_t j = 0; j < ORBIT_POINTS; j++) {
+        // Misma parametrización que SolarSystem_Update
+        Vector3 p = vec3_create(center.x + r * c, center.y + r * tilt * s, center.z + r * s);
+
+        // w de la proyección es la profundidad: detrás del plano cercano no hay punto
+        const Matrix4x4* m = &cam->view_projection;
+        float w = p.x * m->m[0][3] + p.y * m->m[1][3] + p.z * m->m[2][3] + m->m[3][3];
+        Vector2 screen_pos = Camera_WorldToScreen(cam, p, LCD_WIDTH, LCD_HEIGHT);
+
+        // Muy fuera de pantalla se descarta: Bresenham recorrería miles de pasos
+        if (w > cam->near_plane && fabsf(screen_pos.x) < 4096.0f && fabsf(screen_pos.y) < 4096.0f) {
+            int16_t x = (int16_t)screen_pos.x;
+            int16_t y = (int16_t)screen_pos.y;
+
+            cache->x[j] = x;
+            cache->y[j] = y;
+            if (x < cache->x0) cache->x0 = x;
+            if (x > cache->x1) cache->x1 = x;
+            if (y < cache->y0) cache->y0 = y;
+            if (y > cache->y1) cache->y1 = y;
+        } else {
+            cache->x[j] = ORBIT_HIDDEN;
+            cache->y[j] = ORBIT_HIDDEN;
+        }
 
-        body->screen_x = (int16_t)screen_pos.x;
-        body->screen_y = (int16_t)screen_pos.y;
+        float next_c = c * step_c - s * step_s;
+        s = s * step_c + c * step_s;
+        c = next_c;
+    }
+
+    cache->camera_version = cam->version;
+    cache->center = center;
+    cache->valid = 1;
+    cache->changed = 1;
+}
+
+// Solo se reconstruyen las órbitas cuya cámara o centro cambiaron
+static void SolarSystem_UpdateOrbits(SolarSystem* sys, Camera* cam)
+{
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        if (sys->info[h].type != BODY_TYPE_PLANET) continue;
+        if (sys->orbit_radius[h] < 1.0f) continue;
+
+        BodyHandle p = sys->parent[h];
+        Vector3 center = (p != BODY_NONE) ? SolarSystem_GetPosition(sys, p) : vec3_create(0.0f, 0.0f, 0.0f);
+        OrbitCache* cache = &sys->orbit_cache[h];
+
+        if (!cache->valid || cache->camera_version != cam->version ||
+            cache->center.x != center.x || cache->center.y != center.y || cache->center.z != center.z) {
+            SolarSystem_BuildOrbit(sys, h, cam, center);
+        }
+    }
+}
+
+// Caja de la órbita en pantalla: la enviada para borrarla, o la nueva
+static void SolarSystem_OrbitDirty(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+    if (x0 <= x1) {
+        Dirty_Add(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+    }
+}
+
+void SolarSystem_OrbitsLayer(void* ctx, CompositorTile* tile)
+{
+    SolarSystem* sys = (SolarSystem*)ctx;
+
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        const OrbitCache* cache = &sys->orbit_cache[h];
 
-        body->screen_radius = (int16_t)(body->radius * 1.2f);
+        if (!cache->valid) continue;
+        if (cache->x1 < tile->x || cache->x0 >= tile->x + tile->w) continue;
+        if (cache->y1 < tile->y || cache->y0 >= tile->y + tile->h) continue;
 
-        if (body->screen_radius < 2) body->screen_radius = 2;
-        if (body->screen_radius > 100) body->screen_radius = 100;
+        for (uint16_t j = 0; j < ORBIT_POINTS; j++) {
+            uint16_t k = (j + 1 == ORBIT_POINTS) ? 0 : j + 1;
 
-        body->is_visible = 1;
+            if (cache->x[j] == ORBIT_HIDDEN || cache->x[k] == ORBIT_HIDDEN) continue;
 
-        CelestialBody_RenderWithShader(body, time);
+            Compositor_DrawLine(tile, cache->x[j], cache->y[j], cache->x[k], cache->y[k], ORBIT_COLOR);
+        }
     }
 }
+#endif
 
-void SolarSystem_RenderOrbits(SolarSystem* sys, Camera* cam)
+void SolarSystem_PrepareFrame(SolarSystem* sys, Camera* cam, float time)
 {
-    for (uint8_t i = 0; i < sys->body_count; i++) {
-        CelestialBody* body = &sys->bodies[i];
+    SolarSystem_Project(sys, cam);
+    SolarSystem_BinBodies(sys);
+    sys->render_time = time;
+
+#if SOLAR_ORBITS_ENABLE
+    SolarSystem_UpdateOrbits(sys, cam);
+#endif
+
+    // Los discos pequeños salen ya sombreados de la caché de sprites
+    SpriteCache_BeginFrame();
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        sys->sprite[h] = sys->is_visible[h] ? SpriteCache_Acquire(&sys->info[h], sys->screen_radius[h], time)
+                                            : SPRITE_NONE;
+    }
+}
 
-        if (body->type != BODY_TYPE_PLANET) continue;
-        if (body->orbit_radius < 1.0f) continue;
+// Filas de semianchos que se calculan de una vez: las de una banda a lo ancho
+#define BODY_HALF_ROWS  (COMPOSITOR_BAND_PIXELS / LCD_WIDTH)
 
-        uint16_t orbit_color = 0x632C;
+// Píxeles de la región ya resueltos por un cuerpo más cercano, un bit por píxel
+static uint32_t covered[(COMPOSITOR_BAND_PIXELS + 31) / 32];
+static int16_t circle_half[BODY_HALF_ROWS];
 
-        int num_points = 100;
+// Fila dy del disco h dentro de la región, salvo los píxeles ya cubiertos
+static void SolarSystem_BodyRow(const SolarSystem* sys, BodyHandle h, const uint16_t* sprite,
+                                CompositorTile* tile, int16_t dy, int16_t half)
+{
+    int16_t x = sys->screen_x[h];
+    int16_t y = sys->screen_y[h];
+    int16_t r = sys->screen_radius[h];
+    int16_t n = 2 * r + 1;
+    int16_t c0 = x - half - tile->x;
+    int16_t c1 = x + half - tile->x;
 
-        for (int j = 0; j < num_points; j++) {
-            float angle = (float)j / (float)num_points * TWO_PI;
+    if (c0 < 0) c0 = 0;
+    if (c1 >= tile->w) c1 = tile->w - 1;
 
-            Vector3 orbit_point;
-            orbit_point.x = body->orbit_radius * cosf(angle);
-            orbit_point.z = body->orbit_radius * sinf(angle);
-            orbit_point.y = 0.0f;
+    int32_t base = (int32_t)(y + dy - tile->y) * tile->w;
+    uint16_t* row = tile->pixels + base;
 
-            Vector2 screen_pos = Camera_WorldToScreen(cam, orbit_point, LCD_WIDTH, LCD_HEIGHT);
+    for (int16_t col = c0; col <= c1; col++) {
+        int32_t bit = base + col;
 
-            int16_t sx = (int16_t)screen_pos.x;
-            int16_t sy = (int16_t)screen_pos.y;
+        if (covered[bit >> 5] & (1UL << (bit & 31))) continue;
+        covered[bit >> 5] |= 1UL << (bit & 31);
 
-            LCD_DrawPixel(sx, sy, orbit_color);
-            LCD_DrawPixel(sx + 1, sy, orbit_color);
+        int16_t dx = col + tile->x - x;
+        row[col] = sprite ? sprite[(dy + r) * n + (dx + r)]
+                          : CelestialBody_Shade(&sys->info[h], r, dx, dy, sys->render_time);
+    }
+}
+
+void SolarSystem_BodiesLayer(void* ctx, CompositorTile* tile)
+{
+    SolarSystem* sys = (SolarSystem*)ctx;
+    uint16_t mask = SolarSystem_BodiesIn(sys, tile->x, tile->y, tile->x + tile->w - 1, tile->y + tile->h - 1);
+
+    if (mask == 0) return;
+
+    int32_t words = ((int32_t)tile->w * tile->h + 31) / 32;
+    for (int32_t i = 0; i < words; i++) {
+        covered[i] = 0;
+    }
+
+    // draw_order va de atrás hacia adelante: se recorre al revés y el primer disco
+    // que cubre un píxel es el visible
+    for (int8_t i = sys->body_count - 1; i >= 0; i--) {
+        BodyHandle h = sys->draw_order[i];
+
+        if (!(mask & (1u << h))) continue;
+
+        int16_t x = sys->screen_x[h];
+        int16_t y = sys->screen_y[h];
+        int16_t r = sys->screen_radius[h];
+        const uint16_t* sprite = (sys->sprite[h] != SPRITE_NONE) ? SpriteCache_Pixels(sys->sprite[h]) : 0;
+
+        // Único cuerpo de la región: copia del sprite por tramos de fila
+        if (sprite && mask == (1u << h)) {
+            SpriteCache_ComposeTile(sys->sprite[h], x, y, tile);
+            return;
+        }
+
+        int16_t dy_min = tile->y - y;
+        int16_t dy_max = tile->y + tile->h - 1 - y;
+
+        if (dy_min < -r) dy_min = -r;
+        if (dy_max > r) dy_max = r;
+        if (dy_min > dy_max) continue;
+
+        // Rango de |dy| dentro de la región, como en Compositor_FillCircle
+        int16_t near = (dy_min > 0) ? dy_min : ((dy_max < 0) ? -dy_max : 0);
+        int16_t far = (-dy_min > dy_max) ? -dy_min : dy_max;
+
+        // Las regiones estrechas pueden tener más filas que una banda: por tramos de |dy|
+        for (int16_t first = near; first <= far; first += BODY_HALF_ROWS) {
+            int16_t count = far - first + 1;
+            if (count > BODY_HALF_ROWS) count = BODY_HALF_ROWS;
+
+            LCD_CircleHalfWidths(r, first, circle_half, count);
+
+            for (int16_t i = 0; i < count; i++) {
+                int16_t ady = first + i;
+
+                if (-ady >= dy_min) SolarSystem_BodyRow(sys, h, sprite, tile, -ady, circle_half[i]);
+                if (ady > 0 && ady <= dy_max) SolarSystem_BodyRow(sys, h, sprite, tile, ady, circle_half[i]);
+            }
         }
     }
 }
 
-CelestialBody* SolarSystem_GetBodyByName(SolarSystem* sys, const char* name)
+#if SOLAR_TRAILS_ENABLE
+// Punto de la estela con age frames de antigüedad (0 = el más reciente)
+static inline uint8_t SolarSystem_TrailIndex(const BodyTrail* trail, uint8_t age)
 {
-    for (uint8_t i = 0; i < sys->body_count; i++) {
-        if (strcmp(sys->bodies[i].name, name) == 0) {
-            return &sys->bodies[i];
+    return (trail->head + TRAIL_LENGTH - age) % TRAIL_LENGTH;
+}
+
+// Tono del segmento que empieza en age: baja un nivel cada TRAIL_LENGTH / niveles frames
+static inline uint8_t SolarSystem_TrailLevel(uint8_t age)
+{
+    return age * TRAIL_FADE_LEVELS / TRAIL_LENGTH;
+}
+
+// Segmento entre los puntos age y age + 1
+static void SolarSystem_TrailSegmentDirty(const BodyTrail* trail, uint8_t age)
+{
+    if (age + 1 >= trail->count) return;
+
+    uint8_t i0 = SolarSystem_TrailIndex(trail, age);
+    uint8_t i1 = SolarSystem_TrailIndex(trail, age + 1);
+
+    if (trail->x[i0] == TRAIL_GAP || trail->x[i1] == TRAIL_GAP) return;
+
+    int16_t x0 = (trail->x[i0] < trail->x[i1]) ? trail->x[i0] : trail->x[i1];
+    int16_t x1 = (trail->x[i0] < trail->x[i1]) ? trail->x[i1] : trail->x[i0];
+    int16_t y0 = (trail->y[i0] < trail->y[i1]) ? trail->y[i0] : trail->y[i1];
+    int16_t y1 = (trail->y[i0] < trail->y[i1]) ? trail->y[i1] : trail->y[i0];
+
+    Dirty_Add(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+static void SolarSystem_PushTrail(SolarSystem* sys, BodyHandle h)
+{
+    BodyTrail* trail = &sys->trail[h];
+
+    // Con el anillo lleno el segmento más antiguo desaparece: su región se
+    // recompone sin él y queda el fondo
+    if (trail->count == TRAIL_LENGTH) {
+        SolarSystem_TrailSegmentDirty(trail, TRAIL_LENGTH - 2);
+    }
+
+    trail->head = (trail->head + 1) % TRAIL_LENGTH;
+    if (trail->count < TRAIL_LENGTH) trail->count++;
+
+    if (sys->is_visible[h]) {
+        trail->x[trail->head] = sys->screen_x[h];
+        trail->y[trail->head] = sys->screen_y[h];
+    } else {
+        trail->x[trail->head] = TRAIL_GAP;
+        trail->y[trail->head] = TRAIL_GAP;
+    }
+
+    // Segmento nuevo y los que acaban de pasar al tono siguiente: el primero de
+    // cada nivel, redondeando hacia arriba si TRAIL_LENGTH no es múltiplo
+    SolarSystem_TrailSegmentDirty(trail, 0);
+    for (uint8_t level = 1; level < TRAIL_FADE_LEVELS; level++) {
+        SolarSystem_TrailSegmentDirty(trail, (level * TRAIL_LENGTH + TRAIL_FADE_LEVELS - 1) / TRAIL_FADE_LEVELS);
+    }
+}
+
+// Caja de todos los puntos de la estela; 0 si no hay ninguno en pantalla
+static uint8_t SolarSystem_TrailBounds(const BodyTrail* trail, int16_t* x0, int16_t* y0, int16_t* x1, int16_t* y1)
+{
+    uint8_t found = 0;
+
+    for (uint8_t age = 0; age < trail->count; age++) {
+        uint8_t i = SolarSystem_TrailIndex(trail, age);
+        if (trail->x[i] == TRAIL_GAP) continue;
+
+        if (!found || trail->x[i] < *x0) *x0 = trail->x[i];
+        if (!found || trail->x[i] > *x1) *x1 = trail->x[i];
+        if (!found || trail->y[i] < *y0) *y0 = trail->y[i];
+        if (!found || trail->y[i] > *y1) *y1 = trail->y[i];
+        found = 1;
+    }
+    return found;
+}
+
+void SolarSystem_SetTrail(SolarSystem* sys, BodyHandle body, uint8_t enable)
+{
+    if (body >= sys->body_count) return;
+
+    BodyTrail* trail = &sys->trail[body];
+    int16_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+    // La estela que hubiera se borra entera
+    if (trail->enabled && SolarSystem_TrailBounds(trail, &x0, &y0, &x1, &y1)) {
+        Dirty_Add(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+    }
+
+    trail->enabled = enable;
+    trail->head = 0;
+    trail->count = 0;
+}
+
+void SolarSystem_TrailsLayer(void* ctx, CompositorTile* tile)
+{
+    SolarSystem* sys = (SolarSystem*)ctx;
+
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        const BodyTrail* trail = &sys->trail[h];
+
+        if (!trail->enabled || trail->count < 2) continue;
+
+        uint16_t shades[TRAIL_FADE_LEVELS];
+        for (uint8_t level = 0; level < TRAIL_FADE_LEVELS; level++) {
+            uint8_t alpha = BLEND_ALPHA_MAX * (TRAIL_FADE_LEVELS - level) / (TRAIL_FADE_LEVELS + 1);
+            shades[level] = Blend_RGB565(sys->info[h].color, COLOR_SPACE, alpha);
+        }
+
+        // De la cola a la cabeza: donde se cruzan gana el tramo más reciente
+        for (int16_t age = trail->count - 2; age >= 0; age--) {
+            uint8_t i0 = SolarSystem_TrailIndex(trail, age);
+            uint8_t i1 = SolarSystem_TrailIndex(trail, age + 1);
+
+            if (trail->x[i0] == TRAIL_GAP || trail->x[i1] == TRAIL_GAP) continue;
+
+            Compositor_DrawLine(tile, trail->x[i1], trail->y[i1], trail->x[i0], trail->y[i0],
+                                shades[SolarSystem_TrailLevel(age)]);
         }
     }
-    return NULL;
+}
+#endif
+
+void SolarSystem_MarkDirty(SolarSystem* sys)
+{
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        // Posición anterior (para borrar) y actual; el gestor decide si las une
+        if (sys->prev_screen_radius[h] > 0) {
+            int16_t pr = sys->prev_screen_radius[h];
+            Dirty_Add(sys->prev_screen_x[h] - pr, sys->prev_screen_y[h] - pr, 2 * pr + 1, 2 * pr + 1);
+        }
+
+        if (sys->is_visible[h]) {
+            int16_t r = sys->screen_radius[h];
+            Dirty_Add(sys->screen_x[h] - r, sys->screen_y[h] - r, 2 * r + 1, 2 * r + 1);
+
+            sys->prev_screen_x[h] = sys->screen_x[h];
+            sys->prev_screen_y[h] = sys->screen_y[h];
+            sys->prev_screen_radius[h] = sys->screen_radius[h];
+        } else {
+            sys->prev_screen_radius[h] = 0;
+        }
+
+#if SOLAR_TRAILS_ENABLE
+        if (sys->trail[h].enabled) {
+            SolarSystem_PushTrail(sys, h);
+        }
+#endif
+    }
+
+#if SOLAR_ORBITS_ENABLE
+    // Una órbita solo daña la pantalla al reconstruirse: la caja enviada y la nueva
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        OrbitCache* cache = &sys->orbit_cache[h];
+
+        if (!cache->valid || !cache->changed) continue;
+
+        SolarSystem_OrbitDirty(cache->shown_x0, cache->shown_y0, cache->shown_x1, cache->shown_y1);
+        SolarSystem_OrbitDirty(cache->x0, cache->y0, cache->x1, cache->y1);
+
+        cache->shown_x0 = cache->x0;
+        cache->shown_y0 = cache->y0;
+        cache->shown_x1 = cache->x1;
+        cache->shown_y1 = cache->y1;
+        cache->changed = 0;
+    }
+#endif
 }
 
-CelestialBody* SolarSystem_GetBodyByIndex(SolarSystem* sys, uint8_t index)
+void SolarSystem_ScrollScreen(SolarSystem* sys, int16_t dx)
 {
-    if (index < sys->body_count) {
-        return &sys->bodies[index];
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        if (sys->prev_screen_radius[h] <= 0) continue;
+
+        // El disco ya enviado se ve dx columnas más a la izquierda
+        sys->prev_screen_x[h] -= dx;
+
+        // Lo que sale por la izquierda reaparece por la derecha con la vuelta de la RAM
+        int16_t pr = sys->prev_screen_radius[h];
+        int16_t left = sys->prev_screen_x[h] - pr;
+        if (left < 0) {
+            Dirty_Add(LCD_WIDTH + left, sys->prev_screen_y[h] - pr, -left, 2 * pr + 1);
+        }
+    }
+
+#if SOLAR_ORBITS_ENABLE
+    // La órbita enviada se ve dx columnas a la izquierda: MarkDirty borra esa copia
+    // y la repinta en su sitio; aquí solo queda lo que da la vuelta por la derecha
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        OrbitCache* cache = &sys->orbit_cache[h];
+
+        if (!cache->valid || cache->shown_x0 > cache->shown_x1) continue;
+
+        int16_t w = cache->shown_x1 - cache->shown_x0 + 1;
+
+        cache->shown_x0 -= dx;
+        cache->shown_x1 -= dx;
+        cache->changed = 1;
+
+        if (cache->shown_x0 < 0) {
+            Dirty_Add(LCD_WIDTH + cache->shown_x0, cache->shown_y0, (-cache->shown_x0 < w) ? -cache->shown_x0 : w,
+                      cache->shown_y1 - cache->shown_y0 + 1);
+        }
+    }
+#endif
+
+#if SOLAR_TRAILS_ENABLE
+    // Las estelas enviadas también se desplazan: se borra la copia movida y se
+    // repinta la estela en su sitio
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        int16_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+        if (!sys->trail[h].enabled || !SolarSystem_TrailBounds(&sys->trail[h], &x0, &y0, &x1, &y1)) continue;
+
+        int16_t w = x1 - x0 + 1;
+        int16_t left = x0 - dx;
+
+        Dirty_Add(x0, y0, w, y1 - y0 + 1);
+        Dirty_Add(left, y0, w, y1 - y0 + 1);
+        if (left < 0) {
+            Dirty_Add(LCD_WIDTH + left, y0, (-left < w) ? -left : w, y1 - y0 + 1);
+        }
+    }
+#endif
+}
+
+
+BodyHandle SolarSystem_FindBody(SolarSystem* sys, const char* name)
+{
+    for (BodyHandle h = 0; h < sys->body_count; h++) {
+        if (strcmp(sys->info[h].name, name) == 0) {
+            return h;
+        }
+    }
+    return BODY_NONE;
+}
+
+const CelestialBody* SolarSystem_GetBody(SolarSystem* sys, BodyHandle body)
+{
+    if (body < sys->body_count) {
+        return &sys->info[body];
     }
     return NULL;
 }
 
+Vector3 SolarSystem_GetPosition(SolarSystem* sys, BodyHandle body)
+{
+    return vec3_create(sys->pos_x[body], sys->pos_y[body], sys->pos_z[body]);
+}
+
+// El primer cuerpo añadido es el planeta principal, esté donde esté en el orden de dibujo
 void SolarSystem_SetPlanetShader(SolarSystem* sys, ShaderType shader)
 {
     if (sys->body_count > 0) {
-        sys->bodies[0].shader_type = shader;
+        sys->info[0].shader_type = shader;
     }
 }
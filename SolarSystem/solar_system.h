@@ -3,33 +3,179 @@
 
 #include "celestial_body.h"
 #include "camera.h"
+#include "nbody.h"
+#include "sprite_cache.h"
 #include <stdint.h>
 
 #define MAX_BODIES 15
 
+// Órbitas dibujadas con su caché de vértices proyectados (4,4 KB con 15 cuerpos)
+#ifndef SOLAR_ORBITS_ENABLE
+#define SOLAR_ORBITS_ENABLE 0
+#endif
+
+// Vértices de la polilínea de cada órbita
+#define ORBIT_POINTS 64
+#define ORBIT_COLOR  0x632C
+
+// Vértice detrás del plano cercano: los segmentos que lo tocan no se dibujan
+#define ORBIT_HIDDEN INT16_MIN
+
+// Estelas de los cuerpos: capa y anillos de posiciones (2 KB con 15 cuerpos)
+#ifndef SOLAR_TRAILS_ENABLE
+#define SOLAR_TRAILS_ENABLE 1
+#endif
+
+// Estelas: posiciones guardadas por cuerpo y tonos en que se desvanecen
+#ifndef TRAIL_LENGTH
+#define TRAIL_LENGTH       32
+#endif
+#define TRAIL_FADE_LEVELS  4
+
+_Static_assert(TRAIL_LENGTH > TRAIL_FADE_LEVELS && TRAIL_LENGTH <= 255,
+               "el anillo de una estela se recorre con índices de un byte");
+
+// Frame en que el cuerpo no estaba en pantalla: corta la estela
+#define TRAIL_GAP INT16_MIN
+
+// Rejilla de cuerpos en pantalla (320x240 en celdas de 32): cada celda guarda una
+// máscara de los cuerpos cuyo disco la toca, así que MAX_BODIES no pasa de 16
+#define BODY_TILE_SIZE  32
+#define BODY_TILES_X    10
+#define BODY_TILES_Y    8
+
+// Radio máximo de un disco en pantalla. Uno mayor se sustituye por el de este
+// radio con el mismo borde más cercano al centro de la pantalla: sobre el ancho
+// de la pantalla el borde se separa como mucho 160² / (2 * 4096) = 3 píxeles.
+#define BODY_SCREEN_RADIUS_MAX  4096
+
+_Static_assert(MAX_BODIES <= 16, "las máscaras de la rejilla de cuerpos son de 16 bits");
+
+// Índice estable de un cuerpo en los arrays del sistema: no cambia al reordenar
+typedef uint8_t BodyHandle;
+#define BODY_NONE 0xFF
+
+// Últimas posiciones en pantalla en un anillo; head es la más reciente
+typedef struct {
+    int16_t x[TRAIL_LENGTH];
+    int16_t y[TRAIL_LENGTH];
+    uint8_t head;
+    uint8_t count;
+    uint8_t enabled;
+} BodyTrail;
+
+// Órbita ya proyectada, válida mientras coincidan la versión de la cámara y el centro.
+// Cajas inclusivas de los vértices, vacías con x0 > x1: la actual y la enviada al panel.
+typedef struct {
+    int16_t x[ORBIT_POINTS];
+    int16_t y[ORBIT_POINTS];
+    int16_t x0, y0, x1, y1;
+    int16_t shown_x0, shown_y0, shown_x1, shown_y1;
+    uint32_t camera_version;
+    Vector3 center;
+    uint8_t valid;
+    uint8_t changed;
+} OrbitCache;
+
+// Estructura de arrays: cada pasada por frame recorre solo los campos que usa
 typedef struct {
-    CelestialBody bodies[MAX_BODIES];
+    CelestialBody info[MAX_BODIES];
+
+    // Órbita y rotación
+    float orbit_radius[MAX_BODIES];
+    float orbit_angle[MAX_BODIES];
+    float orbit_speed[MAX_BODIES];
+    float orbit_tilt[MAX_BODIES];
+    float orbit_tilt_sin[MAX_BODIES];
+    float orbit_sin[MAX_BODIES];
+    float orbit_cos[MAX_BODIES];
+    float rotation_angle[MAX_BODIES];
+    float rotation_speed[MAX_BODIES];
+    BodyHandle parent[MAX_BODIES];
+
+    // Posición en el mundo
+    float pos_x[MAX_BODIES];
+    float pos_y[MAX_BODIES];
+    float pos_z[MAX_BODIES];
+
+    // Modo gravitatorio: velocidades y masas para NBody_Step
+    float vel_x[MAX_BODIES];
+    float vel_y[MAX_BODIES];
+    float vel_z[MAX_BODIES];
+    float mass[MAX_BODIES];
+
+    // Pantalla: frame actual y lo último enviado al panel
+    int16_t screen_x[MAX_BODIES];
+    int16_t screen_y[MAX_BODIES];
+    int16_t screen_radius[MAX_BODIES];
+    int16_t prev_screen_x[MAX_BODIES];
+    int16_t prev_screen_y[MAX_BODIES];
+    int16_t prev_screen_radius[MAX_BODIES];
+    float distance_to_camera[MAX_BODIES];
+    uint8_t is_visible[MAX_BODIES];
+    uint8_t sprite[MAX_BODIES];           // SPRITE_NONE: se sombrea píxel a píxel
+
+#if SOLAR_ORBITS_ENABLE
+    OrbitCache orbit_cache[MAX_BODIES];
+#endif
+#if SOLAR_TRAILS_ENABLE
+    BodyTrail trail[MAX_BODIES];
+#endif
+
+    // Permutación de dibujo, de atrás hacia adelante
+    BodyHandle draw_order[MAX_BODIES];
+    uint16_t tile_bodies[BODY_TILES_Y][BODY_TILES_X];
     uint8_t body_count;
 
     float time_scale;
     float total_time;
+    float render_time;
+
+    // 0: órbitas circulares cinemáticas; si no, constante G del modo N cuerpos
+    float gravity;
 
 } SolarSystem;
 
 void SolarSystem_Init(SolarSystem* sys);
 void SolarSystem_CreateDefaultSystem(SolarSystem* sys);
-void SolarSystem_AddBody(SolarSystem* sys, CelestialBody body);
+
+// El padre tiene que estar ya en el sistema; BODY_NONE si no queda sitio
+BodyHandle SolarSystem_AddBody(SolarSystem* sys, const CelestialBody* body, BodyHandle parent);
 
 void SolarSystem_Update(SolarSystem* sys, float deltaTime);
 
-void SolarSystem_Render(SolarSystem* sys, Camera* cam);
-void SolarSystem_RenderWithShaders(SolarSystem* sys, Camera* cam, float time);
-void SolarSystem_RenderOrbits(SolarSystem* sys, Camera* cam);
+// Con gravity > 0 los cuerpos salen de su órbita actual con la velocidad que
+// llevaban y desde ahí los mueve la gravedad entre todos; 0 vuelve a las órbitas
+void SolarSystem_SetGravity(SolarSystem* sys, float gravity);
+
+void SolarSystem_PrepareFrame(SolarSystem* sys, Camera* cam, float time);
+
+// Composición por regiones: capa de cuerpos y regiones dañadas en cada frame.
+// La capa resuelve de delante hacia atrás: cada píxel visible se sombrea una vez.
+void SolarSystem_BodiesLayer(void* ctx, CompositorTile* tile);
+void SolarSystem_MarkDirty(SolarSystem* sys);
+void SolarSystem_ScrollScreen(SolarSystem* sys, int16_t dx);
+
+#if SOLAR_ORBITS_ENABLE
+// Polilíneas de las órbitas de los planetas. PrepareFrame las reconstruye solo si
+// cambió la cámara o el centro, y MarkDirty solo marca entonces su caja.
+void SolarSystem_OrbitsLayer(void* ctx, CompositorTile* tile);
+#endif
+
+// Ordena draw_order por distancia; parte del orden del frame anterior
 void SolarSystem_SortByDistance(SolarSystem* sys, Camera* cam);
 
-CelestialBody* SolarSystem_GetBodyByName(SolarSystem* sys, const char* name);
-CelestialBody* SolarSystem_GetBodyByIndex(SolarSystem* sys, uint8_t index);
+BodyHandle SolarSystem_FindBody(SolarSystem* sys, const char* name);
+const CelestialBody* SolarSystem_GetBody(SolarSystem* sys, BodyHandle body);
+Vector3 SolarSystem_GetPosition(SolarSystem* sys, BodyHandle body);
 
 void SolarSystem_SetPlanetShader(SolarSystem* sys, ShaderType shader);
 
+#if SOLAR_TRAILS_ENABLE
+// Cada frame SolarSystem_MarkDirty añade la posición nueva y solo marca el
+// segmento nuevo, el que caduca y los que cambian de tono: coste fijo por cuerpo
+void SolarSystem_SetTrail(SolarSystem* sys, BodyHandle body, uint8_t enable);
+void SolarSystem_TrailsLayer(void* ctx, CompositorTile* tile);
+#endif
+
 #endif
@@ -0,0 +1,188 @@
+#include "sprite_cache.h"
+#include "../Drivers/LCD/lcd_driver.h"
+#include <string.h>
+#include <math.h>
+
+#define SPRITE_ARENA_WORDS (SPRITE_CACHE_BYTES / 2)
+
+// Clave (shader, radio, paso de tiempo) y hueco que ocupa en el almacén
+typedef struct {
+    ShaderType shader;
+    int16_t radius;
+    int32_t time_step;
+    uint16_t offset;      // En palabras de 16 bits: píxeles y detrás la máscara
+    uint16_t words;
+    uint32_t last_used;   // Frame del último uso, para el LRU
+    uint8_t valid;
+} SpriteEntry;
+
+static uint16_t arena[SPRITE_ARENA_WORDS];
+static uint16_t arena_used = 0;
+static SpriteEntry entries[SPRITE_CACHE_ENTRIES];
+static uint32_t frame = 1;
+static SpriteCacheStats stats;
+
+void SpriteCache_BeginFrame(void)
+{
+    frame++;
+}
+
+// Junta los sprites vivos al principio del almacén, en el orden en que estaban
+static void SpriteCache_Compact(void)
+{
+    uint16_t next = 0;
+
+    for (;;) {
+        int16_t first = -1;
+
+        for (uint8_t i = 0; i < SPRITE_CACHE_ENTRIES; i++) {
+            if (!entries[i].valid || entries[i].offset < next) continue;
+            if (first < 0 || entries[i].offset < entries[first].offset) first = i;
+        }
+        if (first < 0) break;
+
+        SpriteEntry* e = &entries[first];
+        memmove(&arena[next], &arena[e->offset], e->words * sizeof(uint16_t));
+        e->offset = next;
+        next += e->words;
+    }
+
+    arena_used = next;
+}
+
+// Entrada libre con words palabras al final del almacén; desaloja por LRU lo
+// que haga falta, salvo lo ya usado en este frame. -1 si no se puede.
+static int16_t SpriteCache_Reserve(uint16_t words)
+{
+    if (words > SPRITE_ARENA_WORDS) return -1;
+
+    for (;;) {
+        int16_t slot = -1;
+
+        for (uint8_t i = 0; i < SPRITE_CACHE_ENTRIES; i++) {
+            if (!entries[i].valid) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot >= 0 && arena_used + words <= SPRITE_ARENA_WORDS) return slot;
+
+        int16_t victim = -1;
+        for (uint8_t i = 0; i < SPRITE_CACHE_ENTRIES; i++) {
+            if (!entries[i].valid || entries[i].last_used == frame) continue;
+            if (victim < 0 || entries[i].last_used < entries[victim].last_used) victim = i;
+        }
+        if (victim < 0) return -1;
+
+        entries[victim].valid = 0;
+        stats.evictions++;
+        SpriteCache_Compact();
+    }
+}
+
+uint8_t SpriteCache_Acquire(const CelestialBody* body, int16_t r, float time)
+{
+    if (r > SPRITE_MAX_RADIUS) return SPRITE_NONE;
+
+    int32_t step = (int32_t)floorf(time / SPRITE_TIME_STEP);
+
+    for (uint8_t i = 0; i < SPRITE_CACHE_ENTRIES; i++) {
+        SpriteEntry* e = &entries[i];
+
+        if (e->valid && e->shader == body->shader_type && e->radius == r && e->time_step == step) {
+            e->last_used = frame;
+            stats.hits++;
+            return i;
+        }
+    }
+
+    stats.misses++;
+
+    int16_t n = 2 * r + 1;
+    uint16_t words = n * n + (n + 1) / 2;
+    int16_t slot = SpriteCache_Reserve(words);
+
+    if (slot < 0) return SPRITE_NONE;
+
+    SpriteEntry* e = &entries[slot];
+    e->shader = body->shader_type;
+    e->radius = r;
+    e->time_step = step;
+    e->offset = arena_used;
+    e->words = words;
+    e->last_used = frame;
+    e->valid = 1;
+    arena_used += words;
+
+    // Máscara de cobertura: semiancho de cada fila del disco
+    uint16_t* pixels = &arena[e->offset];
+    uint8_t* half = (uint8_t*)(pixels + n * n);
+    int16_t widths[SPRITE_MAX_RADIUS + 1];
+    float t = step * SPRITE_TIME_STEP;
+
+    LCD_CircleHalfWidths(r, 0, widths, r + 1);
+
+    for (int16_t dy = -r; dy <= r; dy++) {
+        int16_t h = widths[(dy < 0) ? -dy : dy];
+        uint16_t* row = pixels + (dy + r) * n + r;
+
+        half[dy + r] = (uint8_t)h;
+        for (int16_t dx = -h; dx <= h; dx++) {
+            row[dx] = CelestialBody_Shade(body, r, dx, dy, t);
+        }
+    }
+
+    return slot;
+}
+
+const uint16_t* SpriteCache_Pixels(uint8_t sprite)
+{
+    return &arena[entries[sprite].offset];
+}
+
+void SpriteCache_ComposeTile(uint8_t sprite, int16_t x, int16_t y, CompositorTile* tile)
+{
+    const SpriteEntry* e = &entries[sprite];
+    int16_t r = e->radius;
+    int16_t n = 2 * r + 1;
+    const uint16_t* pixels = &arena[e->offset];
+    const uint8_t* half = (const uint8_t*)(pixels + n * n);
+
+    int16_t dy_min = tile->y - y;
+    int16_t dy_max = tile->y + tile->h - 1 - y;
+
+    if (dy_min < -r) dy_min = -r;
+    if (dy_max > r) dy_max = r;
+
+    for (int16_t dy = dy_min; dy <= dy_max; dy++) {
+        int16_t x0 = x - half[dy + r];
+        int16_t x1 = x + half[dy + r];
+
+        if (x0 < tile->x) x0 = tile->x;
+        if (x1 >= tile->x + tile->w) x1 = tile->x + tile->w - 1;
+        if (x0 > x1) continue;
+
+        memcpy(tile->pixels + (int32_t)(y + dy - tile->y) * tile->w + (x0 - tile->x),
+               pixels + (dy + r) * n + (x0 - x + r), (x1 - x0 + 1) * sizeof(uint16_t));
+    }
+}
+
+void SpriteCache_Draw(uint8_t sprite, int16_t x, int16_t y)
+{
+    const SpriteEntry* e = &entries[sprite];
+    int16_t r = e->radius;
+    int16_t n = 2 * r + 1;
+    const uint16_t* pixels = &arena[e->offset];
+    const uint8_t* half = (const uint8_t*)(pixels + n * n);
+
+    // Una ráfaga por fila; LCD_DrawBitmap recorta y sigue el scroll
+    for (int16_t dy = -r; dy <= r; dy++) {
+        int16_t h = half[dy + r];
+        LCD_DrawBitmap(x - h, y + dy, 2 * h + 1, 1, pixels + (dy + r) * n + (r - h));
+    }
+}
+
+const SpriteCacheStats* SpriteCache_GetStats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,53 @@
+#ifndef SPRITE_CACHE_H
+#define SPRITE_CACHE_H
+
+#include "celestial_body.h"
+#include "../Graphics/compositor.h"
+#include <stdint.h>
+
+// RAM para discos ya sombreados: un sprite de radio r ocupa (2r+1)² píxeles más
+// 2r+1 bytes de máscara (unos 1.3 KB con r = 12)
+#ifndef SPRITE_CACHE_BYTES
+#define SPRITE_CACHE_BYTES 8192
+#endif
+
+#ifndef SPRITE_CACHE_ENTRIES
+#define SPRITE_CACHE_ENTRIES 16
+#endif
+
+// Por encima de este radio el cuerpo se sombrea directamente en cada frame
+#ifndef SPRITE_MAX_RADIUS
+#define SPRITE_MAX_RADIUS 12
+#endif
+
+// Paso de tiempo del shader: dentro del mismo paso se reutiliza el sprite
+#ifndef SPRITE_TIME_STEP
+#define SPRITE_TIME_STEP 0.25f
+#endif
+
+#define SPRITE_NONE 0xFF
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+} SpriteCacheStats;
+
+// Abre un frame: los sprites pedidos desde aquí no se desalojan hasta el siguiente
+void SpriteCache_BeginFrame(void);
+
+// Sprite del disco de radio r con el shader del cuerpo en el instante time. Los
+// cuerpos con el mismo shader y radio comparten sprite. SPRITE_NONE si el disco es
+// grande o no cabe sin desalojar sprites del frame actual.
+uint8_t SpriteCache_Acquire(const CelestialBody* body, int16_t r, float time);
+
+// Píxeles fila a fila, (2r+1)² valores; válidos hasta la siguiente SpriteCache_Acquire
+const uint16_t* SpriteCache_Pixels(uint8_t sprite);
+
+// Copia del disco centrado en (x, y), por tramos de fila según la máscara
+void SpriteCache_ComposeTile(uint8_t sprite, int16_t x, int16_t y, CompositorTile* tile);
+void SpriteCache_Draw(uint8_t sprite, int16_t x, int16_t y);
+
+const SpriteCacheStats* SpriteCache_GetStats(void);
+
+#endif
@@ -31,6 +31,34 @@ float fast_cos(float x)
     return fast_sin(x + HALF_PI);
 }
 
+// Reducción a [-PI/4, PI/4] por cuadrantes (PI/2 en tres partes, Cody-Waite) y
+// polinomios minimax de sin y cos; error relativo en torno a 1e-7 para |x| < 1e4
+void sincos_batch(const float* angles, float* sin_out, float* cos_out, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        float x = angles[i];
+        float kf = x * 0.63661977236f;
+        int32_t k = (int32_t)(kf + ((kf >= 0.0f) ? 0.5f : -0.5f));
+        float fk = (float)k;
+
+        float r = x - fk * 1.5703125f;
+        r -= fk * 4.837512969970703125e-4f;
+        r -= fk * 7.54978995489188216e-8f;
+
+        float r2 = r * r;
+        float s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+        float c = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+        // Cuadrante: (s, c), (c, -s), (-s, -c), (-c, s)
+        uint32_t q = (uint32_t)k & 3;
+        float qs = (q & 1) ? c : s;
+        float qc = (q & 1) ? s : c;
+
+        sin_out[i] = (q & 2) ? -qs : qs;
+        cos_out[i] = ((q + 1) & 2) ? -qc : qc;
+    }
+}
+
 float clamp(float value, float min, float max)
 {
     if (value < min) return min;
@@ -25,6 +25,9 @@ typedef struct {
 float fast_sqrt(float x);
 float fast_sin(float x);
 float fast_cos(float x);
+
+// Seno y coseno de count ángulos: sin ramas ni llamadas, el bucle se puede vectorizar
+void sincos_batch(const float* angles, float* sin_out, float* cos_out, uint16_t count);
 float clamp(float value, float min, float max);
 float lerp(float a, float b, float t);
 